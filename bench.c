@@ -0,0 +1,768 @@
+/**
+* \page Bench
+* \brief Suite de mesures des chemins critiques du jeu, avec compteurs matériels et référence enregistrée.
+* \author Ewen THÉPOT
+*
+* Cas mesurés :
+* - pas : progression du serpent par le moteur du jeu (jouerTour()). Une partie est d'abord jouée par un bot glouton
+*   et ses mouvements enregistrés ; le cas rejoue ensuite exactement ces mouvements et doit finir dans le même état ;
+* - pomme : apparition d'une pomme sur un plateau rempli à différents niveaux ;
+* - peinture : dessin complet du plateau ;
+* - rendu : un tour de la partie affichée (effacement de la queue, dessin de la tête, écriture du terminal).
+*
+* Chaque cas est répété et la meilleure répétition est gardée. Les cycles, instructions, défauts de cache et
+* erreurs de prédiction de branchement sont lus avec perf_event_open ; sans compteurs, seul le temps est mesuré.
+* Les résultats peuvent être enregistrés comme référence JSON, et comparés à une référence : le programme se
+* termine en erreur si un cas régresse au-delà du seuil (cycles par opération, ou temps sans compteurs).
+* La référence doit avoir été mesurée avec le même nombre de tours et de répétitions ; une comparaison au temps
+* demande au moins TOURS_MIN_COMPARAISON_TEMPS tours.
+*
+* Utilisation : ./bench [-t tours] [-e référence à écrire] [-r référence à comparer] [-s seuil en %]
+*/
+
+#define SNAKE_SANS_MAIN // Réutiliser le moteur du jeu sans son programme principal
+#include "snake.c"
+#include <stdint.h> // Pour les valeurs des compteurs
+#include <sys/ioctl.h> // Pour activer les compteurs
+#include <sys/syscall.h> // Pour perf_event_open
+#include <linux/perf_event.h> // Pour les compteurs matériels
+
+// ----------------------------- CONSTANTES -------------------------------------
+
+/**
+ *
+ * \def TOURS_BENCH_DEFAUT
+ *
+ * \brief constante pour le nombre de tours joués par chaque cas de progression par défaut
+ *
+ */
+#define TOURS_BENCH_DEFAUT 5000000 // Nombre de tours par cas de progression
+
+/**
+ *
+ * \def TOURS_MAX_BENCH
+ *
+ * \brief constante pour le nombre maximum de tours de la partie enregistrée
+ *
+ */
+#define TOURS_MAX_BENCH 20000 // Nombre maximum de mouvements enregistrés
+
+/**
+ *
+ * \def GRAINE_BENCH
+ *
+ * \brief constante pour la graine des parties mesurées
+ *
+ */
+#define GRAINE_BENCH 20241130 // Graine des parties (mesures reproductibles)
+
+/**
+ *
+ * \def REPETITIONS_BENCH
+ *
+ * \brief constante pour le nombre de répétitions de chaque cas (la meilleure est gardée)
+ *
+ */
+#define REPETITIONS_BENCH 5 // Répétitions de chaque cas
+
+/**
+ *
+ * \def SEUIL_REGRESSION_DEFAUT
+ *
+ * \brief constante pour la hausse maximum tolérée par rapport à la référence, en pourcentage
+ *
+ */
+#define SEUIL_REGRESSION_DEFAUT 10.0 // Seuil de régression par défaut (%)
+
+/**
+ *
+ * \def TOURS_MIN_COMPARAISON_TEMPS
+ *
+ * \brief constante pour le nombre minimum de tours d'une comparaison au temps (sans compteurs matériels)
+ *
+ * \details En dessous, les cas les plus courts (pomme, rendu : tours / 50 opérations) durent moins d'une milliseconde
+ * par répétition et le bruit de l'ordonnanceur dépasse le seuil de régression.
+ *
+ */
+#define TOURS_MIN_COMPARAISON_TEMPS 5000000 // Nombre de tours par défaut
+
+/**
+ *
+ * \def NOMBRE_COMPTEURS
+ *
+ * \brief constante pour le nombre de compteurs matériels lus
+ *
+ */
+#define NOMBRE_COMPTEURS 4 // Cycles, instructions, défauts de cache, erreurs de branchement
+
+/**
+ *
+ * \def LONGUEUR_NOM_CAS
+ *
+ * \brief constante pour la longueur maximum du nom d'un cas
+ *
+ */
+#define LONGUEUR_NOM_CAS 48 // Longueur maximum d'un nom de cas, '\0' compris
+
+/**
+ *
+ * \def CAS_MAX
+ *
+ * \brief constante pour le nombre maximum de cas de la suite
+ *
+ */
+#define CAS_MAX 32 // Nombre maximum de cas
+
+
+// ------------------------------- TYPES ----------------------------------------
+
+/**
+ *
+ * \struct Mesure
+ *
+ * \brief Temps et compteurs accumulés par une répétition d'un cas
+ *
+ */
+typedef struct
+{
+    long operations; // Nombre d'opérations mesurées
+    double secondes; // Temps passé dans les opérations
+    double compteurs[NOMBRE_COMPTEURS]; // Valeur de chaque compteur (négative s'il est indisponible)
+} Mesure;
+
+/**
+ *
+ * \struct Cas
+ *
+ * \brief Cas de la suite : fonction mesurée et son paramètre
+ *
+ */
+typedef struct
+{
+    char nom[LONGUEUR_NOM_CAS]; // Nom du cas, clé de la référence
+    void (*executer)(int parametre, long operations, Mesure *mesure); // Exécute le cas et mesure ses opérations
+    int parametre; // Niveau de remplissage, ou paramètre inutilisé
+    long operations; // Nombre d'opérations par répétition
+    Mesure meilleure; // Meilleure répétition, par opération
+} Cas;
+
+/**
+ *
+ * \struct Compteurs
+ *
+ * \brief Compteurs matériels du processus, activés ensemble
+ *
+ */
+typedef struct
+{
+    int descripteurs[NOMBRE_COMPTEURS]; // Descripteur de chaque compteur (-1 s'il est indisponible)
+    int groupe; // Descripteur du premier compteur, qui active tout le groupe (-1 : aucun compteur)
+} Compteurs;
+
+/**
+ *
+ * \struct Enregistrement
+ *
+ * \brief Partie enregistrée sur le plateau standard et état attendu à sa fin
+ *
+ */
+typedef struct
+{
+    char mouvements[TOURS_MAX_BENCH]; // Mouvements du bot glouton
+    int nombreMouvements; // Nombre de mouvements
+    int score; // Score à la fin de la partie
+    int taille; // Taille à la fin de la partie
+} Enregistrement;
+
+
+// Niveaux de remplissage de la zone de la tête mesurés pour l'apparition des pommes (%)
+static const int REMPLISSAGES[] = {0, 50, 90, 99};
+
+// Nom et configuration de chaque compteur
+static const char *NOMS_COMPTEURS[NOMBRE_COMPTEURS] = {"cycles", "instructions", "defautsCache", "erreursBranchement"};
+static const uint64_t CONFIGURATIONS_COMPTEURS[NOMBRE_COMPTEURS] = {PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES};
+
+
+// Prototypes des fonctions
+double secondes(); // Temps écoulé (horloge monotone)
+void ouvrirCompteurs(); // Ouvre les compteurs matériels disponibles
+void demarrerMesure(Mesure *mesure); // Début d'une plage mesurée
+void arreterMesure(Mesure *mesure); // Fin d'une plage mesurée
+char choisirDirection(const Partie *partie); // Bot glouton utilisé pour enregistrer les mouvements
+void enregistrerMouvements(Enregistrement *enregistrement); // Joue et enregistre une partie
+void executerPasPartie(int inutilise, long operations, Mesure *mesure); // Cas : pas du moteur du jeu
+void executerPomme(int remplissage, long operations, Mesure *mesure); // Cas : apparition d'une pomme
+void executerPeinture(int inutilise, long operations, Mesure *mesure); // Cas : dessin complet du plateau
+void executerRendu(int inutilise, long operations, Mesure *mesure); // Cas : tour de la partie affichée
+void verifierEtat(int score, int taille, const Enregistrement *enregistrement); // Compare l'état final d'un passage à la partie enregistrée
+void mesurerCas(Cas *cas); // Répète un cas et garde la meilleure répétition
+double valeurReference(const char *reference, const char *nom, const char *cle); // Lit une valeur d'un cas dans une référence JSON
+long parametreReference(const char *reference, const char *cle); // Lit un paramètre de la mesure d'une référence JSON
+bool ecrireReference(const char *chemin, const Cas cas[], int nombreCas, long tours); // Enregistre les résultats comme référence JSON
+
+
+// Variables globales
+
+static Compteurs compteurs = {{-1, -1, -1, -1}, -1}; // Compteurs matériels du processus
+static Niveau niveau; // Niveau du plateau standard
+static Partie gabarit; // Partie du plateau standard au début de la partie
+static Enregistrement enregistrement; // Partie enregistrée sur le plateau standard
+static bool coherent = true; // Chaque passage finit dans l'état de la partie enregistrée
+static int sortie = -1; // Sortie standard d'origine, pendant que la peinture et le rendu écrivent dans /dev/null
+
+
+// Programme principal
+
+/**
+* \fn int main(int argc, char *argv[])
+* \brief Mesure chaque cas, affiche les résultats, les enregistre et les compare à une référence.
+*
+* \param argc Nombre d'arguments.
+* \param argv Arguments : options -t, -e, -r et -s.
+* \return 0 si aucun cas ne régresse et si le moteur finit dans l'état de la partie enregistrée, une autre valeur sinon.
+*/
+int main(int argc, char *argv[])
+{
+    static Cas cas[CAS_MAX];
+    long tours = TOURS_BENCH_DEFAUT;
+    const char *ecriture = NULL; // Référence à écrire
+    const char *comparaison = NULL; // Référence à comparer
+    double seuil = SEUIL_REGRESSION_DEFAUT;
+    int nombreCas = 0;
+    int option;
+    while ((option = getopt(argc, argv, "t:e:r:s:")) != -1)
+    {
+        switch (option)
+        {
+            case 't': tours = atol(optarg); break;
+            case 'e': ecriture = optarg; break;
+            case 'r': comparaison = optarg; break;
+            case 's': seuil = atof(optarg); break;
+            default: tours = 0; break;
+        }
+    }
+    if ((tours < 10000) || (seuil < 0.0))
+    {
+        fprintf(stderr, "Utilisation : %s [-t tours (10000 au moins)] [-e référence à écrire] [-r référence à comparer] [-s seuil en %%]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    char *reference = NULL; // Contenu de la référence à comparer
+    if (comparaison != NULL)
+    {
+        FILE *fichier = fopen(comparaison, "r");
+        long longueur = 0;
+        if ((fichier == NULL) || (fseek(fichier, 0, SEEK_END) != 0) || ((longueur = ftell(fichier)) < 0) || ((reference = calloc(longueur + 1, 1)) == NULL))
+        {
+            perror(comparaison);
+            return EXIT_FAILURE;
+        }
+        rewind(fichier);
+        longueur = fread(reference, 1, longueur, fichier);
+        fclose(fichier);
+        long toursReference = parametreReference(reference, "tours");
+        long repetitionsReference = parametreReference(reference, "repetitions");
+        if ((toursReference != tours) || (repetitionsReference != REPETITIONS_BENCH)) // Des mesures d'autres longueurs ne se comparent pas
+        {
+            fprintf(stderr, "%s : référence mesurée avec %ld tours et %ld répétitions, relancer avec -t %ld (ou enregistrer une nouvelle référence)\n", comparaison, toursReference, repetitionsReference, toursReference);
+            return EXIT_FAILURE;
+        }
+    }
+
+    // Préparation : plateau standard et partie enregistrée
+    initNiveauStandard(&niveau);
+    initPartie(&gabarit, &niveau, GRAINE_BENCH, false);
+    enregistrerMouvements(&enregistrement);
+
+    // Liste des cas
+    cas[nombreCas] = (Cas){.nom = "pas.partie.80x40", .executer = executerPasPartie, .operations = tours};
+    nombreCas++;
+    for (int r = 0; r < (int)(sizeof(REMPLISSAGES) / sizeof(REMPLISSAGES[0])); r++)
+    {
+        cas[nombreCas] = (Cas){.executer = executerPomme, .parametre = REMPLISSAGES[r], .operations = tours / 50};
+        snprintf(cas[nombreCas++].nom, LONGUEUR_NOM_CAS, "pomme.remplissage.%d", REMPLISSAGES[r]);
+    }
+    cas[nombreCas] = (Cas){.nom = "peinture.plateau", .executer = executerPeinture, .operations = tours / 10000};
+    nombreCas++;
+    cas[nombreCas] = (Cas){.nom = "rendu.tour", .executer = executerRendu, .operations = tours / 50};
+    nombreCas++;
+
+    // Mesures
+    ouvrirCompteurs();
+    printf("%ld tours par cas de progression, %d répétitions, compteurs matériels %s\n\n", tours, REPETITIONS_BENCH, (compteurs.groupe >= 0) ? "disponibles" : "indisponibles (temps seulement)");
+    if ((reference != NULL) && (compteurs.groupe < 0) && (tours < TOURS_MIN_COMPARAISON_TEMPS))
+    {
+        fprintf(stderr, "Attention : comparaison au temps avec moins de %d tours (-t), régressions peu fiables\n\n", TOURS_MIN_COMPARAISON_TEMPS);
+    }
+    printf("%-24s %10s %10s %10s %10s %10s %9s\n", "Cas", "ns/op", "cycles/op", "instr/op", "cache/op", "branch/op", "écart");
+    int regressions = 0;
+    for (int c = 0; c < nombreCas; c++)
+    {
+        mesurerCas(&cas[c]);
+        const Mesure *meilleure = &cas[c].meilleure;
+        printf("%-24s %10.2f", cas[c].nom, 1e9 * meilleure->secondes);
+        for (int k = 0; k < NOMBRE_COMPTEURS; k++)
+        {
+            if (meilleure->compteurs[k] >= 0)
+            {
+                printf(" %10.2f", meilleure->compteurs[k]);
+            }
+            else
+            {
+                printf(" %10s", "-");
+            }
+        }
+        if (reference != NULL) // Écart à la référence : cycles si les deux mesures en ont, temps sinon
+        {
+            double avant = valeurReference(reference, cas[c].nom, NOMS_COMPTEURS[0]);
+            double apres = meilleure->compteurs[0];
+            if ((avant < 0) || (apres < 0))
+            {
+                avant = valeurReference(reference, cas[c].nom, "ns");
+                apres = 1e9 * meilleure->secondes;
+            }
+            if (avant > 0)
+            {
+                double ecart = 100.0 * (apres - avant) / avant;
+                bool regression = (ecart > seuil);
+                regressions += regression;
+                printf(" %+8.1f%%%s", ecart, regression ? "  RÉGRESSION" : "");
+            }
+            else
+            {
+                printf(" %9s", "nouveau");
+            }
+        }
+        printf("\n");
+        fflush(stdout);
+    }
+    free(reference);
+    if ((ecriture != NULL) && (ecrireReference(ecriture, cas, nombreCas, tours) == false))
+    {
+        perror(ecriture);
+        return EXIT_FAILURE;
+    }
+    if (coherent == false)
+    {
+        fprintf(stderr, "Le moteur ne finit pas dans l'état de la partie enregistrée\n");
+        return EXIT_FAILURE;
+    }
+    if (regressions > 0)
+    {
+        fprintf(stderr, "%d cas en régression de plus de %.1f %% par rapport à %s\n", regressions, seuil, comparaison);
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
+
+
+// Fonctions
+
+/**
+ * \fn double secondes()
+ * \brief Temps écoulé depuis une origine fixe (horloge monotone).
+ *
+ * \return Le temps en secondes.
+ */
+double secondes() // Temps écoulé (horloge monotone)
+{
+    struct timespec instant;
+    clock_gettime(CLOCK_MONOTONIC, &instant);
+    return instant.tv_sec + instant.tv_nsec / 1e9;
+}
+
+/**
+ * \fn void ouvrirCompteurs()
+ * \brief Ouvre les compteurs matériels du processus (espace utilisateur seulement), regroupés derrière le compteur de cycles.
+ *
+ * Sans compteur de cycles (machine virtuelle, perf_event_paranoid trop restrictif), aucun compteur n'est utilisé ;
+ * un autre compteur indisponible est simplement absent des résultats.
+ */
+void ouvrirCompteurs() // Ouvre les compteurs matériels disponibles
+{
+    for (int k = 0; k < NOMBRE_COMPTEURS; k++)
+    {
+        struct perf_event_attr attributs;
+        memset(&attributs, 0, sizeof(attributs));
+        attributs.size = sizeof(attributs);
+        attributs.type = PERF_TYPE_HARDWARE;
+        attributs.config = CONFIGURATIONS_COMPTEURS[k];
+        attributs.disabled = (k == 0); // Le groupe est activé par son premier compteur
+        attributs.exclude_kernel = 1;
+        attributs.exclude_hv = 1;
+        compteurs.descripteurs[k] = syscall(SYS_perf_event_open, &attributs, 0, -1, compteurs.groupe, 0);
+        if ((k == 0) && (compteurs.descripteurs[k] < 0))
+        {
+            return;
+        }
+        compteurs.groupe = compteurs.descripteurs[0];
+    }
+}
+
+/**
+ * \fn void demarrerMesure(Mesure *mesure)
+ * \brief Début d'une plage mesurée : active les compteurs puis relève l'horloge.
+ *
+ * \param mesure Mesure qui accumule les plages.
+ */
+void demarrerMesure(Mesure *mesure) // Début d'une plage mesurée
+{
+    if (compteurs.groupe >= 0)
+    {
+        ioctl(compteurs.groupe, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+    mesure->secondes -= secondes();
+}
+
+/**
+ * \fn void arreterMesure(Mesure *mesure)
+ * \brief Fin d'une plage mesurée : relève l'horloge puis désactive les compteurs.
+ *
+ * Les compteurs ne sont pas remis à zéro entre deux plages : leur valeur est lue par mesurerCas().
+ *
+ * \param mesure Mesure qui accumule les plages.
+ */
+void arreterMesure(Mesure *mesure) // Fin d'une plage mesurée
+{
+    mesure->secondes += secondes();
+    if (compteurs.groupe >= 0)
+    {
+        ioctl(compteurs.groupe, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+    }
+}
+
+/**
+ * \fn char choisirDirection(const Partie *partie)
+ * \brief Bot glouton : se rapproche de la pomme par une case sans obstacle ni segment, sinon garde sa direction.
+ *
+ * \param partie Partie en cours.
+ * \return La direction choisie.
+ */
+char choisirDirection(const Partie *partie) // Bot glouton utilisé pour enregistrer les mouvements
+{
+    const char directions[NOMBRE_DIRECTIONS] = {UP, DOWN, LEFT, RIGHT}; // Dans l'ordre des codes de direction
+    char choix = partie->direction;
+    int meilleureDistance = -1;
+    for (int d = 0; d < NOMBRE_DIRECTIONS; d++)
+    {
+        Lien lien = partie->niveau->liens[partie->lesX[0]][partie->lesY[0]][d + 1];
+        int distance = abs(lien.x - partie->xPomme) + abs(lien.y - partie->yPomme);
+        bool libre = lien.portail || ((caseObstacle(partie, lien.x, lien.y) == false) && (partie->occupation[lien.x][lien.y] == 0));
+        if (libre && ((meilleureDistance < 0) || (distance < meilleureDistance)))
+        {
+            meilleureDistance = distance;
+            choix = directions[d];
+        }
+    }
+    return choix;
+}
+
+/**
+ * \fn void enregistrerMouvements(Enregistrement *enregistrement)
+ * \brief Joue une partie avec le bot glouton depuis le gabarit et enregistre ses mouvements et son état final.
+ *
+ * \param enregistrement Enregistrement à remplir.
+ */
+void enregistrerMouvements(Enregistrement *enregistrement) // Joue et enregistre une partie
+{
+    Partie *partie = malloc(sizeof(Partie));
+    int nombre = 0;
+    reinitialiserPartie(partie, &gabarit);
+    while ((partieTerminee(partie) == false) && (nombre < TOURS_MAX_BENCH))
+    {
+        enregistrement->mouvements[nombre] = choisirDirection(partie);
+        jouerTour(partie, enregistrement->mouvements[nombre]);
+        nombre++;
+    }
+    enregistrement->nombreMouvements = nombre;
+    enregistrement->score = partie->score;
+    enregistrement->taille = partie->taille;
+    free(partie);
+}
+
+/**
+ * \fn void executerPasPartie(int inutilise, long operations, Mesure *mesure)
+ * \brief Cas : rejoue la partie enregistrée avec le moteur du jeu (jouerTour()), remise à zéro hors mesure entre deux passages.
+ *
+ * \param inutilise Paramètre inutilisé.
+ * \param operations Nombre minimum de tours à jouer.
+ * \param mesure Mesure des tours.
+ */
+void executerPasPartie(int inutilise, long operations, Mesure *mesure) // Cas : pas du moteur du jeu
+{
+    (void)inutilise;
+    Partie *partie = malloc(sizeof(Partie));
+    while (mesure->operations < operations)
+    {
+        reinitialiserPartie(partie, &gabarit); // Remise à zéro hors mesure
+        demarrerMesure(mesure);
+        for (int i = 0; i < enregistrement.nombreMouvements; i++)
+        {
+            jouerTour(partie, enregistrement.mouvements[i]);
+        }
+        arreterMesure(mesure);
+        mesure->operations += enregistrement.nombreMouvements;
+    }
+    verifierEtat(partie->score, partie->taille, &enregistrement);
+    free(partie);
+}
+
+/**
+ * \fn void executerPomme(int remplissage, long operations, Mesure *mesure)
+ * \brief Cas : fait apparaître des pommes sur le plateau standard dont la zone de la tête est occupée à remplissage %.
+ *
+ * Les cases les plus éloignées de la tête (parcours en largeur) sont occupées en premier : les cases restantes restent
+ * d'un seul tenant autour de la tête, sans poche fermée. Chaque pomme est retirée avant la suivante.
+ *
+ * \param remplissage Pourcentage des cases de la zone de la tête occupées.
+ * \param operations Nombre de pommes.
+ * \param mesure Mesure des apparitions.
+ */
+void executerPomme(int remplissage, long operations, Mesure *mesure) // Cas : apparition d'une pomme
+{
+    Partie *partie = malloc(sizeof(Partie));
+    static int file[NOMBRE_CASES_TABLEAU]; // Cases de la zone de la tête, par distance croissante (x * HAUTEUR_TABLEAU_PLATEAU + y)
+    static bool vue[LARGEUR_TABLEAU_PLATEAU][HAUTEUR_TABLEAU_PLATEAU];
+    int fin = 0;
+    reinitialiserPartie(partie, &gabarit);
+    partie->coordPlateau[partie->xPomme][partie->yPomme] = CARACTERE_VIDE;
+    memset(vue, false, sizeof(vue));
+    vue[partie->lesX[0]][partie->lesY[0]] = true;
+    file[fin++] = partie->lesX[0] * HAUTEUR_TABLEAU_PLATEAU + partie->lesY[0];
+    for (int debut = 0; debut < fin; debut++) // Parcours en largeur depuis la tête, par les cases libres
+    {
+        int x = file[debut] / HAUTEUR_TABLEAU_PLATEAU;
+        int y = file[debut] % HAUTEUR_TABLEAU_PLATEAU;
+        for (int code = 1; code <= NOMBRE_DIRECTIONS; code++)
+        {
+            Lien lien = partie->niveau->liens[x][y][code];
+            if ((vue[lien.x][lien.y] == false) && (partie->zone[lien.x][lien.y] != AUCUNE_ZONE))
+            {
+                vue[lien.x][lien.y] = true;
+                file[fin++] = lien.x * HAUTEUR_TABLEAU_PLATEAU + lien.y;
+            }
+        }
+    }
+    for (int n = 0; n < (fin - 1) * remplissage / 100; n++) // Remplissage de la zone de la tête, de la case la plus éloignée vers la tête
+    {
+        occuperCase(partie, file[fin - 1 - n] / HAUTEUR_TABLEAU_PLATEAU, file[fin - 1 - n] % HAUTEUR_TABLEAU_PLATEAU);
+    }
+    demarrerMesure(mesure);
+    for (long n = 0; n < operations; n++)
+    {
+        ajouterPomme(partie);
+        partie->coordPlateau[partie->xPomme][partie->yPomme] = CARACTERE_VIDE; // Retirer la pomme (une écriture)
+    }
+    arreterMesure(mesure);
+    mesure->operations += operations;
+    free(partie);
+}
+
+/**
+ * \fn void executerPeinture(int inutilise, long operations, Mesure *mesure)
+ * \brief Cas : dessine le plateau complet (dessinerPlateau()), la sortie standard étant redirigée vers /dev/null.
+ *
+ * \param inutilise Paramètre inutilisé.
+ * \param operations Nombre de dessins.
+ * \param mesure Mesure des dessins.
+ */
+void executerPeinture(int inutilise, long operations, Mesure *mesure) // Cas : dessin complet du plateau
+{
+    (void)inutilise;
+    fflush(stdout);
+    sortie = dup(STDOUT_FILENO);
+    int nul = open("/dev/null", O_WRONLY);
+    dup2(nul, STDOUT_FILENO);
+    close(nul);
+    demarrerMesure(mesure);
+    for (long n = 0; n < operations; n++)
+    {
+        dessinerPlateau(gabarit.coordPlateau);
+        fflush(stdout); // L'écriture du terminal fait partie du dessin
+    }
+    arreterMesure(mesure);
+    mesure->operations += operations;
+    dup2(sortie, STDOUT_FILENO);
+    close(sortie);
+}
+
+/**
+ * \fn void executerRendu(int inutilise, long operations, Mesure *mesure)
+ * \brief Cas : joue des tours de la partie enregistrée sur le plateau standard avec affichage, comme le programme
+ * principal (progression dessinée, diffusion, écriture du terminal), la sortie standard étant redirigée vers /dev/null.
+ *
+ * \param inutilise Paramètre inutilisé.
+ * \param operations Nombre minimum de tours.
+ * \param mesure Mesure des tours.
+ */
+void executerRendu(int inutilise, long operations, Mesure *mesure) // Cas : tour de la partie affichée
+{
+    (void)inutilise;
+    Partie *partie = malloc(sizeof(Partie));
+    fflush(stdout);
+    sortie = dup(STDOUT_FILENO);
+    int nul = open("/dev/null", O_WRONLY);
+    dup2(nul, STDOUT_FILENO);
+    close(nul);
+    while (mesure->operations < operations)
+    {
+        reinitialiserPartie(partie, &gabarit); // Remise à zéro hors mesure
+        partie->affichage = true;
+        demarrerMesure(mesure);
+        for (int i = 0; i < enregistrement.nombreMouvements; i++)
+        {
+            jouerTour(partie, enregistrement.mouvements[i]);
+            diffuserTour(partie->tours);
+            fflush(stdout); // Une écriture du terminal par tour, comme le jeu
+        }
+        arreterMesure(mesure);
+        mesure->operations += enregistrement.nombreMouvements;
+    }
+    dup2(sortie, STDOUT_FILENO);
+    close(sortie);
+    free(partie);
+}
+
+/**
+ * \fn void verifierEtat(int score, int taille, const Enregistrement *enregistrement)
+ * \brief Compare l'état final d'un passage à celui de la partie enregistrée.
+ *
+ * \param score Score à la fin du dernier passage.
+ * \param taille Taille à la fin du dernier passage.
+ * \param enregistrement Partie enregistrée.
+ */
+void verifierEtat(int score, int taille, const Enregistrement *enregistrement) // Compare l'état final d'un passage à la partie enregistrée
+{
+    coherent &= (score == enregistrement->score) && (taille == enregistrement->taille);
+}
+
+/**
+ * \fn void mesurerCas(Cas *cas)
+ * \brief Répète un cas REPETITIONS_BENCH fois et garde, pour le temps et chaque compteur, la meilleure valeur par opération.
+ *
+ * \param cas Cas à mesurer.
+ */
+void mesurerCas(Cas *cas) // Répète un cas et garde la meilleure répétition
+{
+    for (int r = 0; r < REPETITIONS_BENCH; r++)
+    {
+        Mesure mesure = {0};
+        for (int k = 0; k < NOMBRE_COMPTEURS; k++)
+        {
+            if (compteurs.descripteurs[k] >= 0)
+            {
+                ioctl(compteurs.descripteurs[k], PERF_EVENT_IOC_RESET, 0);
+            }
+        }
+        cas->executer(cas->parametre, cas->operations, &mesure);
+        double operations = (mesure.operations > 0) ? mesure.operations : 1;
+        if ((r == 0) || (mesure.secondes / operations < cas->meilleure.secondes))
+        {
+            cas->meilleure.secondes = mesure.secondes / operations;
+        }
+        for (int k = 0; k < NOMBRE_COMPTEURS; k++)
+        {
+            uint64_t valeur = 0;
+            double parOperation = -1; // Compteur indisponible
+            if ((compteurs.descripteurs[k] >= 0) && (read(compteurs.descripteurs[k], &valeur, sizeof(valeur)) == sizeof(valeur)))
+            {
+                parOperation = valeur / operations;
+            }
+            if ((r == 0) || (parOperation < cas->meilleure.compteurs[k]))
+            {
+                cas->meilleure.compteurs[k] = parOperation;
+            }
+        }
+        cas->meilleure.operations = mesure.operations;
+    }
+}
+
+/**
+ * \fn double valeurReference(const char *reference, const char *nom, const char *cle)
+ * \brief Lit une valeur d'un cas dans le contenu d'une référence écrite par ecrireReference().
+ *
+ * \param reference Contenu de la référence.
+ * \param nom Nom du cas.
+ * \param cle Clé de la valeur (ns ou nom d'un compteur).
+ * \return La valeur, ou -1 si le cas ou la valeur est absent.
+ */
+double valeurReference(const char *reference, const char *nom, const char *cle) // Lit une valeur d'un cas dans une référence JSON
+{
+    char motif[LONGUEUR_NOM_CAS + 16];
+    snprintf(motif, sizeof(motif), "\"nom\": \"%s\"", nom);
+    const char *debut = strstr(reference, motif);
+    if (debut == NULL)
+    {
+        return -1;
+    }
+    const char *fin = strchr(debut, '}'); // Fin de l'objet du cas
+    snprintf(motif, sizeof(motif), "\"%s\": ", cle);
+    const char *valeur = strstr(debut, motif);
+    if ((valeur == NULL) || ((fin != NULL) && (valeur > fin)))
+    {
+        return -1;
+    }
+    char *suite;
+    double resultat = strtod(valeur + strlen(motif), &suite);
+    return (suite == valeur + strlen(motif)) ? -1 : resultat; // null : compteur indisponible
+}
+
+/**
+ * \fn long parametreReference(const char *reference, const char *cle)
+ * \brief Lit un paramètre de la mesure (tours, repetitions) dans l'en-tête d'une référence écrite par ecrireReference().
+ *
+ * \param reference Contenu de la référence.
+ * \param cle Clé du paramètre.
+ * \return La valeur, ou -1 si le paramètre est absent.
+ */
+long parametreReference(const char *reference, const char *cle) // Lit un paramètre de la mesure d'une référence JSON
+{
+    char motif[32];
+    snprintf(motif, sizeof(motif), "\"%s\": ", cle);
+    const char *valeur = strstr(reference, motif);
+    const char *cas = strstr(reference, "\"cas\"");
+    if ((valeur == NULL) || ((cas != NULL) && (valeur > cas))) // Seulement dans l'en-tête, avant la liste des cas
+    {
+        return -1;
+    }
+    char *suite;
+    long resultat = strtol(valeur + strlen(motif), &suite, 10);
+    return (suite == valeur + strlen(motif)) ? -1 : resultat;
+}
+
+/**
+ * \fn bool ecrireReference(const char *chemin, const Cas cas[], int nombreCas, long tours)
+ * \brief Enregistre les résultats par opération de chaque cas comme référence JSON.
+ *
+ * \param chemin Chemin du fichier.
+ * \param cas Cas mesurés.
+ * \param nombreCas Nombre de cas.
+ * \param tours Nombre de tours par cas de progression.
+ * \return true si le fichier est écrit, false sinon.
+ */
+bool ecrireReference(const char *chemin, const Cas cas[], int nombreCas, long tours) // Enregistre les résultats comme référence JSON
+{
+    FILE *fichier = fopen(chemin, "w");
+    if (fichier == NULL)
+    {
+        return false;
+    }
+    fprintf(fichier, "{\n  \"version\": 1,\n  \"tours\": %ld,\n  \"repetitions\": %d,\n  \"cas\": [\n", tours, REPETITIONS_BENCH);
+    for (int c = 0; c < nombreCas; c++)
+    {
+        fprintf(fichier, "    {\"nom\": \"%s\", \"operations\": %ld, \"ns\": %.3f", cas[c].nom, cas[c].meilleure.operations, 1e9 * cas[c].meilleure.secondes);
+        for (int k = 0; k < NOMBRE_COMPTEURS; k++)
+        {
+            if (cas[c].meilleure.compteurs[k] >= 0)
+            {
+                fprintf(fichier, ", \"%s\": %.3f", NOMS_COMPTEURS[k], cas[c].meilleure.compteurs[k]);
+            }
+            else
+            {
+                fprintf(fichier, ", \"%s\": null", NOMS_COMPTEURS[k]);
+            }
+        }
+        fprintf(fichier, "}%s\n", (c + 1 < nombreCas) ? "," : "");
+    }
+    fprintf(fichier, "  ]\n}\n");
+    return fclose(fichier) == 0;
+}
@@ -0,0 +1,304 @@
+/**
+* \page Bilan
+* \brief Résumé d'un fichier de télémétrie écrit par le tournoi.
+* \author Ewen THÉPOT
+*
+* Les blocs sont lus l'un après l'autre et leurs colonnes parcourues directement, sans conversion de texte.
+* Les bots sont regroupés par nom : un fichier alimenté par plusieurs lancements donne un seul bilan par bot.
+*
+* Utilisation : ./bilan <télémétrie>
+*/
+
+#define SNAKE_SANS_MAIN // Réutiliser les constantes du jeu sans son programme principal
+#include "snake.c"
+#include "telemetrie.c"
+
+// ----------------------------- CONSTANTES -------------------------------------
+
+/**
+ *
+ * \def LONGUEUR_NOM_MAX
+ *
+ * \brief constante pour la longueur maximum du nom d'un bot
+ *
+ */
+#define LONGUEUR_NOM_MAX 32 // Longueur maximum d'un nom, '\0' compris
+
+/**
+ *
+ * \def BOTS_MAX
+ *
+ * \brief constante pour le nombre maximum de bots différents d'un fichier
+ *
+ */
+#define BOTS_MAX 256 // Nombre maximum de noms différents
+
+
+// ------------------------------- TYPES ----------------------------------------
+
+/**
+ *
+ * \struct BilanBot
+ *
+ * \brief Cumuls des parties et des échantillons d'un bot
+ *
+ */
+typedef struct
+{
+    char nom[LONGUEUR_NOM_MAX]; // Nom du bot
+    long parties; // Nombre de parties
+    long pommes; // Nombre total de pommes mangées
+    long gagnees; // Parties où toutes les pommes ont été mangées
+    long tours; // Nombre total de tours
+    long tailles; // Somme des tailles finales
+    long causes[NOMBRE_CAUSES]; // Parties par cause de fin
+    long echantillons; // Nombre d'échantillons
+    long taillesEchantillons; // Somme des tailles aux échantillons
+} BilanBot;
+
+/**
+ *
+ * \struct Bilan
+ *
+ * \brief Cumuls de tout le fichier
+ *
+ */
+typedef struct
+{
+    BilanBot bots[BOTS_MAX]; // Un cumul par nom de bot
+    int nombreBots; // Nombre de noms différents
+    int indices[BOTS_MAX]; // Cumul de chaque bot du dernier bloc de noms
+    long blocs; // Nombre de blocs lus
+    long octets; // Nombre d'octets lus
+} Bilan;
+
+
+// Prototypes des fonctions
+uint32_t lireColonne(const unsigned char colonne[], int octets, uint32_t ligne); // Lit une valeur d'une colonne
+bool lireNoms(Bilan *bilan, const unsigned char donnees[], const EnteteBloc *entete); // Lit un bloc de noms
+bool lireParties(Bilan *bilan, const unsigned char donnees[], const EnteteBloc *entete); // Cumule un bloc de parties
+bool lireEchantillons(Bilan *bilan, const unsigned char donnees[], const EnteteBloc *entete); // Cumule un bloc d'échantillons
+
+
+// Programme principal
+
+/**
+* \fn int main(int argc, char *argv[])
+* \brief Lit un fichier de télémétrie et affiche le bilan de chaque bot.
+*
+* \param argc Nombre d'arguments.
+* \param argv Arguments : chemin du fichier de télémétrie.
+* \return 0 en cas de succès, une autre valeur si le fichier est illisible.
+*/
+int main(int argc, char *argv[])
+{
+    static Bilan bilan; // Hors de la pile : un cumul par nom possible
+    EnteteBloc entete;
+    unsigned char *donnees = NULL;
+    size_t capacite = 0;
+    bool lisible = true;
+    if (argc < 2)
+    {
+        fprintf(stderr, "Utilisation : %s <télémétrie>\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    FILE *fichier = fopen(argv[1], "rb");
+    if (fichier == NULL)
+    {
+        perror(argv[1]);
+        return EXIT_FAILURE;
+    }
+    for (int i = 0; i < BOTS_MAX; i++) // Aucun nom lu : les bots sont désignés par leur indice
+    {
+        bilan.indices[i] = -1;
+    }
+    while (lisible && (fread(&entete, sizeof(entete), 1, fichier) == 1))
+    {
+        if (entete.octets > capacite) // Colonnes plus grandes que les précédentes
+        {
+            capacite = entete.octets;
+            donnees = realloc(donnees, capacite);
+        }
+        lisible = (entete.version == VERSION_TELEMETRIE) && ((entete.octets == 0) || ((donnees != NULL) && (fread(donnees, entete.octets, 1, fichier) == 1)));
+        if (lisible && (entete.type == BLOC_NOMS))
+        {
+            lisible = lireNoms(&bilan, donnees, &entete);
+        }
+        else if (lisible && (entete.type == BLOC_PARTIES))
+        {
+            lisible = lireParties(&bilan, donnees, &entete);
+        }
+        else if (lisible && (entete.type == BLOC_ECHANTILLONS))
+        {
+            lisible = lireEchantillons(&bilan, donnees, &entete);
+        } // Un bloc de type inconnu est ignoré
+        bilan.blocs += lisible;
+        bilan.octets += lisible ? (long)(sizeof(entete) + entete.octets) : 0;
+    }
+    fclose(fichier);
+    free(donnees);
+    if (lisible == false)
+    {
+        fprintf(stderr, "Bloc %ld illisible dans %s (après %ld octets)\n", bilan.blocs + 1, argv[1], bilan.octets);
+    }
+    printf("%s : %ld blocs, %ld octets\n\n", argv[1], bilan.blocs, bilan.octets);
+    printf("%-14s %9s %8s %8s %8s %8s %8s %8s %8s %8s %8s %12s %8s\n", "Bot", "Parties", "Pommes", "Gagnées", "Tours", "Taille", NOMS_CAUSES[CAUSE_VICTOIRE], NOMS_CAUSES[CAUSE_BORDURE], NOMS_CAUSES[CAUSE_PAVE], NOMS_CAUSES[CAUSE_CORPS], NOMS_CAUSES[CAUSE_TOURS], "Échantillons", "Taille");
+    for (int b = 0; b < bilan.nombreBots; b++)
+    {
+        const BilanBot *bot = &bilan.bots[b];
+        double parties = (bot->parties > 0) ? bot->parties : 1;
+        printf("%-14s %9ld %8.2f %7.1f%% %8.1f %8.2f", bot->nom, bot->parties, bot->pommes / parties, 100.0 * bot->gagnees / parties, bot->tours / parties, bot->tailles / parties);
+        for (int c = 0; c < NOMBRE_CAUSES; c++) // Proportion de chaque cause de fin
+        {
+            printf(" %7.1f%%", 100.0 * bot->causes[c] / parties);
+        }
+        printf(" %12ld %8.2f\n", bot->echantillons, (double)bot->taillesEchantillons / ((bot->echantillons > 0) ? bot->echantillons : 1));
+    }
+    return lisible ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+
+// Fonctions
+
+/**
+ * \fn uint32_t lireColonne(const unsigned char colonne[], int octets, uint32_t ligne)
+ * \brief Lit une valeur d'une colonne (les colonnes se suivent sans alignement).
+ *
+ * \param colonne Début de la colonne.
+ * \param octets Taille d'une valeur de la colonne (1, 2 ou 4).
+ * \param ligne Indice de la ligne.
+ * \return La valeur.
+ */
+uint32_t lireColonne(const unsigned char colonne[], int octets, uint32_t ligne) // Lit une valeur d'une colonne
+{
+    uint8_t valeur8;
+    uint16_t valeur16;
+    uint32_t valeur32;
+    switch (octets)
+    {
+    case 1:
+        memcpy(&valeur8, colonne + ligne, 1);
+        return valeur8;
+    case 2:
+        memcpy(&valeur16, colonne + 2 * ligne, 2);
+        return valeur16;
+    default:
+        memcpy(&valeur32, colonne + 4 * ligne, 4);
+        return valeur32;
+    }
+}
+
+/**
+ * \fn bool lireNoms(Bilan *bilan, const unsigned char donnees[], const EnteteBloc *entete)
+ * \brief Lit un bloc de noms : les blocs suivants désignent les bots par leur indice dans ce bloc.
+ *
+ * \param bilan Cumuls du fichier.
+ * \param donnees Colonnes du bloc.
+ * \param entete En-tête du bloc.
+ * \return true si le bloc est valide, false sinon.
+ */
+bool lireNoms(Bilan *bilan, const unsigned char donnees[], const EnteteBloc *entete) // Lit un bloc de noms
+{
+    uint32_t position = 0;
+    if (entete->lignes > BOTS_MAX)
+    {
+        return false;
+    }
+    for (uint32_t i = 0; i < entete->lignes; i++)
+    {
+        const char *nom = (const char *)donnees + position;
+        size_t longueur = strnlen(nom, entete->octets - position);
+        if ((position + longueur >= entete->octets) || (longueur >= LONGUEUR_NOM_MAX)) // Nom sans '\0' ou trop long
+        {
+            return false;
+        }
+        int b = 0;
+        while ((b < bilan->nombreBots) && (strcmp(bilan->bots[b].nom, nom) != 0)) // Cumul existant de ce nom
+        {
+            b++;
+        }
+        if (b == BOTS_MAX)
+        {
+            return false;
+        }
+        if (b == bilan->nombreBots)
+        {
+            strcpy(bilan->bots[b].nom, nom);
+            bilan->nombreBots++;
+        }
+        bilan->indices[i] = b;
+        position += longueur + 1;
+    }
+    return true;
+}
+
+/**
+ * \fn bool lireParties(Bilan *bilan, const unsigned char donnees[], const EnteteBloc *entete)
+ * \brief Cumule un bloc de parties, colonne après colonne.
+ *
+ * \param bilan Cumuls du fichier.
+ * \param donnees Colonnes du bloc.
+ * \param entete En-tête du bloc.
+ * \return true si le bloc est valide, false sinon.
+ */
+bool lireParties(Bilan *bilan, const unsigned char donnees[], const EnteteBloc *entete) // Cumule un bloc de parties
+{
+    uint32_t n = entete->lignes;
+    if ((entete->colonnes != COLONNES_PARTIES) || (entete->octets != n * OCTETS_LIGNE_PARTIE))
+    {
+        return false;
+    }
+    const unsigned char *bots = donnees + 4 * n; // La colonne des graines n'est pas cumulée
+    const unsigned char *scores = bots + n;
+    const unsigned char *tailles = scores + 2 * n;
+    const unsigned char *tours = tailles + 2 * n;
+    const unsigned char *causes = tours + 4 * n;
+    for (uint32_t i = 0; i < n; i++)
+    {
+        int b = bilan->indices[bots[i]];
+        if ((b < 0) || (causes[i] >= NOMBRE_CAUSES)) // Bot sans nom ou cause inconnue
+        {
+            return false;
+        }
+        BilanBot *bot = &bilan->bots[b];
+        uint32_t score = lireColonne(scores, 2, i);
+        bot->parties++;
+        bot->pommes += score;
+        bot->gagnees += (score == NOMBRE_DE_POMMES);
+        bot->tailles += lireColonne(tailles, 2, i);
+        bot->tours += lireColonne(tours, 4, i);
+        bot->causes[causes[i]]++;
+    }
+    return true;
+}
+
+/**
+ * \fn bool lireEchantillons(Bilan *bilan, const unsigned char donnees[], const EnteteBloc *entete)
+ * \brief Cumule un bloc d'échantillons.
+ *
+ * \param bilan Cumuls du fichier.
+ * \param donnees Colonnes du bloc.
+ * \param entete En-tête du bloc.
+ * \return true si le bloc est valide, false sinon.
+ */
+bool lireEchantillons(Bilan *bilan, const unsigned char donnees[], const EnteteBloc *entete) // Cumule un bloc d'échantillons
+{
+    uint32_t n = entete->lignes;
+    if ((entete->colonnes != COLONNES_ECHANTILLONS) || (entete->octets != n * OCTETS_LIGNE_ECHANTILLON))
+    {
+        return false;
+    }
+    const unsigned char *bots = donnees + 4 * n;
+    const unsigned char *tailles = bots + n + 4 * n + n + n; // Après les colonnes tour, X et Y
+    for (uint32_t i = 0; i < n; i++)
+    {
+        int b = bilan->indices[bots[i]];
+        if (b < 0)
+        {
+            return false;
+        }
+        bilan->bots[b].echantillons++;
+        bilan->bots[b].taillesEchantillons += lireColonne(tailles, 2, i);
+    }
+    return true;
+}
@@ -0,0 +1,508 @@
+/**
+* \page Bots
+* \brief Politiques de jeu automatiques (bots) pour le jeu Snake.
+* \author Ewen THÉPOT
+*
+* Chaque bot choisit la prochaine direction du serpent à partir de l'état d'une partie.
+* Les bots ne modifient jamais la partie reçue : ils simulent leurs mouvements sur des copies,
+* avec les mêmes fonctions progresser() et jouerTour() que le jeu.
+*
+* Ce fichier est inclus après snake.c par les outils de simulation (tournament, entrainement).
+*/
+
+// ----------------------------- CONSTANTES -------------------------------------
+
+/**
+ *
+ * \def PROFONDEUR_ANTICIPATION
+ *
+ * \brief constante pour le nombre de mouvements simulés par le bot anticipation
+ *
+ */
+#define PROFONDEUR_ANTICIPATION 3 // Nombre de mouvements simulés à l'avance
+
+/**
+ *
+ * \def ESPACE_LIBRE_SUFFISANT
+ *
+ * \brief constante pour le nombre de cases libres à partir duquel une position est jugée sûre
+ *
+ * \details Limite le parcours du plateau lors du calcul de l'espace libre autour de la tête.
+ *
+ */
+#define ESPACE_LIBRE_SUFFISANT (2 * TAILLE_MAX_SERPENT) // Nombre de cases libres jugé suffisant pour ne pas être piégé
+
+/**
+ *
+ * \def SCORE_MORT
+ *
+ * \brief constante pour l'évaluation d'une position où le serpent est mort
+ *
+ */
+#define SCORE_MORT (-1.0e9) // Évaluation d'une collision
+
+/**
+ *
+ * \def TOURS_MAX_PARTIE
+ *
+ * \brief constante pour le nombre maximum de mouvements d'une partie jouée par un bot
+ *
+ * \details Un bot qui tourne en rond sans manger ne doit pas bloquer les simulations.
+ *
+ */
+#define TOURS_MAX_PARTIE 5000 // Nombre maximum de mouvements avant d'arrêter une partie
+
+/**
+ *
+ * \def NOMBRE_POIDS
+ *
+ * \brief constante pour le nombre de critères (et donc de poids) du bot pondéré
+ *
+ * \details Critères, dans l'ordre : distance à la pomme, espace libre, queue atteignable, pomme mangée, tout droit.
+ *
+ */
+#define NOMBRE_POIDS 5 // Nombre de poids du bot pondéré
+
+/**
+ *
+ * \def LIMITE_ESPACE_PONDERE
+ *
+ * \brief constante pour le nombre maximum de cases comptées par le critère espace libre du bot pondéré
+ *
+ */
+#define LIMITE_ESPACE_PONDERE (4 * TAILLE_MAX_SERPENT) // Cases comptées au plus pour l'espace libre
+
+
+// Directions testées par les bots
+static const char DIRECTIONS[NOMBRE_DIRECTIONS] = {UP, DOWN, LEFT, RIGHT};
+
+// Poids par défaut du bot pondéré, réglés à la main avant tout entraînement
+static const double POIDS_DEFAUT[NOMBRE_POIDS] = {-1.0, 40.0, 20.0, 100.0, 0.5};
+
+
+// Prototypes des fonctions
+bool caseVoisine(const Partie *partie, int x, int y, char direction, int *xVoisin, int *yVoisin); // Calcule la case atteinte depuis (x, y) dans une direction, issues comprises
+bool mouvementSur(const Partie *partie, char direction); // Indique si un mouvement ne provoque pas de collision immédiate
+int distancePomme(const Partie *partie, int x, int y); // Distance de Manhattan entre une case et la pomme
+void marquerCorps(const Partie *partie, bool occupee[LARGEUR_TABLEAU_PLATEAU][HAUTEUR_TABLEAU_PLATEAU]); // Marque les obstacles et le corps du serpent
+int espaceLibre(const Partie *partie, int limite); // Compte les cases libres accessibles depuis la tête
+char botGlouton(const Partie *partie); // Se rapproche de la pomme en évitant les collisions immédiates
+char botChemin(const Partie *partie); // Suit le plus court chemin jusqu'à la pomme
+char botAnticipation(const Partie *partie); // Simule plusieurs mouvements à l'avance
+bool queueAtteignable(const Partie *partie); // Indique si la tête peut rejoindre la queue du serpent
+char botPondere(const Partie *partie, const double poids[NOMBRE_POIDS]); // Choisit le mouvement qui maximise une somme pondérée de critères
+bool chargerPoids(const char *chemin, double poids[NOMBRE_POIDS]); // Lit les meilleurs poids enregistrés par l'outil entrainement
+
+
+// Fonctions
+
+/**
+ * \fn bool caseVoisine(const Partie *partie, int x, int y, char direction, int *xVoisin, int *yVoisin)
+ * \brief Calcule la case atteinte depuis (x, y) dans une direction, en passant par les issues (table des liens du niveau).
+ *
+ * \param partie Partie en cours (niveau).
+ * \param x Coordonnée X de départ.
+ * \param y Coordonnée Y de départ.
+ * \param direction Direction du mouvement.
+ * \param xVoisin Coordonnée X de la case atteinte.
+ * \param yVoisin Coordonnée Y de la case atteinte.
+ * \return true si le mouvement quitte la case de départ, false sinon (direction invalide ou bord du tableau).
+ */
+bool caseVoisine(const Partie *partie, int x, int y, char direction, int *xVoisin, int *yVoisin) // Calcule la case atteinte depuis (x, y) dans une direction, issues comprises
+{
+    Lien lien = partie->niveau->liens[x][y][CODES_DIRECTIONS[(unsigned char)direction]]; // Même déplacement que la tête du serpent
+    *xVoisin = lien.x;
+    *yVoisin = lien.y;
+    return (lien.x != x) || (lien.y != y);
+}
+
+/**
+ * \fn bool mouvementSur(const Partie *partie, char direction)
+ * \brief Indique si un mouvement ne provoque pas de collision immédiate.
+ *
+ * Le mouvement est simulé sur une copie de la partie avec progresser(), les règles sont donc exactement celles du jeu.
+ *
+ * \param partie Partie en cours.
+ * \param direction Direction testée.
+ * \return true si le serpent survit au mouvement, false sinon.
+ */
+bool mouvementSur(const Partie *partie, char direction) // Indique si un mouvement ne provoque pas de collision immédiate
+{
+    Partie copie = *partie; // Copie de la partie sur laquelle le mouvement est simulé
+    copie.affichage = false;
+    progresser(&copie, direction);
+    return copie.collision == false;
+}
+
+/**
+ * \fn int distancePomme(const Partie *partie, int x, int y)
+ * \brief Distance de Manhattan entre une case et la pomme (sans tenir compte des issues).
+ *
+ * \param partie Partie en cours.
+ * \param x Coordonnée X de la case.
+ * \param y Coordonnée Y de la case.
+ * \return La distance entre la case et la pomme.
+ */
+int distancePomme(const Partie *partie, int x, int y) // Distance de Manhattan entre une case et la pomme
+{
+    return abs(partie->xPomme - x) + abs(partie->yPomme - y);
+}
+
+/**
+ * \fn void marquerCorps(const Partie *partie, bool occupee[LARGEUR_TABLEAU_PLATEAU][HAUTEUR_TABLEAU_PLATEAU])
+ * \brief Marque les cases bloquées du plateau : obstacles et corps du serpent.
+ *
+ * La queue n'est pas marquée puisqu'elle libère sa case au prochain mouvement.
+ *
+ * \param partie Partie en cours.
+ * \param occupee Tableau rempli avec true pour chaque case bloquée.
+ */
+void marquerCorps(const Partie *partie, bool occupee[LARGEUR_TABLEAU_PLATEAU][HAUTEUR_TABLEAU_PLATEAU]) // Marque les obstacles et le corps du serpent
+{
+    for (int i = 0; i < LARGEUR_TABLEAU_PLATEAU; i++)
+    {
+        for (int j = 0; j < HAUTEUR_TABLEAU_PLATEAU; j++)
+        {
+            occupee[i][j] = caseObstacle(partie, i, j);
+        }
+    }
+    for (int i = 0; i < partie->taille - 1; i++) // Tout le corps sauf la queue
+    {
+        occupee[partie->lesX[i]][partie->lesY[i]] = true;
+    }
+}
+
+/**
+ * \fn int espaceLibre(const Partie *partie, int limite)
+ * \brief Compte les cases libres accessibles depuis la tête du serpent.
+ *
+ * Le parcours s'arrête dès que la limite est atteinte : il sert à détecter les impasses, pas à mesurer tout le plateau.
+ *
+ * \param partie Partie en cours.
+ * \param limite Nombre de cases au-delà duquel le parcours s'arrête.
+ * \return Le nombre de cases accessibles, au plus limite.
+ */
+int espaceLibre(const Partie *partie, int limite) // Compte les cases libres accessibles depuis la tête
+{
+    bool occupee[LARGEUR_TABLEAU_PLATEAU][HAUTEUR_TABLEAU_PLATEAU]; // Cases bloquées ou déjà visitées
+    int fileX[NOMBRE_CASES_TABLEAU]; // File du parcours en largeur
+    int fileY[NOMBRE_CASES_TABLEAU];
+    int debut = 0;
+    int fin = 0;
+    int compte = 0;
+    marquerCorps(partie, occupee);
+    fileX[fin] = partie->lesX[0];
+    fileY[fin] = partie->lesY[0];
+    fin++;
+    while ((debut < fin) && (compte < limite)) // Parcourir les cases accessibles jusqu'à la limite
+    {
+        int x = fileX[debut];
+        int y = fileY[debut];
+        debut++;
+        for (int d = 0; d < NOMBRE_DIRECTIONS; d++)
+        {
+            int xVoisin, yVoisin;
+            if (caseVoisine(partie, x, y, DIRECTIONS[d], &xVoisin, &yVoisin) && (occupee[xVoisin][yVoisin] == false))
+            {
+                occupee[xVoisin][yVoisin] = true; // Ne pas compter deux fois la même case
+                fileX[fin] = xVoisin;
+                fileY[fin] = yVoisin;
+                fin++;
+                compte++;
+            }
+        }
+    }
+    return (compte < limite) ? compte : limite;
+}
+
+/**
+ * \fn char botGlouton(const Partie *partie)
+ * \brief Bot glouton : se rapproche de la pomme en évitant les collisions immédiates.
+ *
+ * \param partie Partie en cours.
+ * \return La direction choisie.
+ */
+char botGlouton(const Partie *partie) // Se rapproche de la pomme en évitant les collisions immédiates
+{
+    char choix = partie->direction; // Continuer tout droit si aucun mouvement n'est sûr
+    int meilleureDistance = -1;
+    for (int d = 0; d < NOMBRE_DIRECTIONS; d++)
+    {
+        int x, y;
+        if ((DIRECTIONS[d] != directionOpposee(partie->direction)) && mouvementSur(partie, DIRECTIONS[d]))
+        {
+            caseVoisine(partie, partie->lesX[0], partie->lesY[0], DIRECTIONS[d], &x, &y);
+            int distance = distancePomme(partie, x, y);
+            if ((meilleureDistance < 0) || (distance < meilleureDistance))
+            {
+                meilleureDistance = distance;
+                choix = DIRECTIONS[d];
+            }
+        }
+    }
+    return choix;
+}
+
+/**
+ * \fn char botChemin(const Partie *partie)
+ * \brief Bot chemin : suit le plus court chemin jusqu'à la pomme (parcours en largeur, issues comprises).
+ *
+ * Si la pomme n'est pas accessible, le bot se comporte comme le bot glouton.
+ *
+ * \param partie Partie en cours.
+ * \return La direction choisie.
+ */
+char botChemin(const Partie *partie) // Suit le plus court chemin jusqu'à la pomme
+{
+    bool occupee[LARGEUR_TABLEAU_PLATEAU][HAUTEUR_TABLEAU_PLATEAU]; // Cases bloquées ou déjà visitées
+    int fileX[NOMBRE_CASES_TABLEAU]; // File du parcours en largeur
+    int fileY[NOMBRE_CASES_TABLEAU];
+    char premiere[NOMBRE_CASES_TABLEAU]; // Premier mouvement du chemin menant à chaque case de la file
+    int debut = 0;
+    int fin = 0;
+    marquerCorps(partie, occupee);
+    for (int d = 0; d < NOMBRE_DIRECTIONS; d++) // Les premiers mouvements doivent être sûrs
+    {
+        int x, y;
+        if ((DIRECTIONS[d] != directionOpposee(partie->direction)) && caseVoisine(partie, partie->lesX[0], partie->lesY[0], DIRECTIONS[d], &x, &y) && (occupee[x][y] == false) && mouvementSur(partie, DIRECTIONS[d]))
+        {
+            occupee[x][y] = true;
+            fileX[fin] = x;
+            fileY[fin] = y;
+            premiere[fin] = DIRECTIONS[d];
+            fin++;
+        }
+    }
+    while (debut < fin) // Parcourir le plateau jusqu'à la pomme
+    {
+        int x = fileX[debut];
+        int y = fileY[debut];
+        char direction = premiere[debut];
+        debut++;
+        if ((x == partie->xPomme) && (y == partie->yPomme)) // Pomme atteinte
+        {
+            return direction;
+        }
+        for (int d = 0; d < NOMBRE_DIRECTIONS; d++)
+        {
+            int xVoisin, yVoisin;
+            if (caseVoisine(partie, x, y, DIRECTIONS[d], &xVoisin, &yVoisin) && (occupee[xVoisin][yVoisin] == false))
+            {
+                occupee[xVoisin][yVoisin] = true;
+                fileX[fin] = xVoisin;
+                fileY[fin] = yVoisin;
+                premiere[fin] = direction;
+                fin++;
+            }
+        }
+    }
+    return botGlouton(partie); // Pomme inaccessible
+}
+
+/**
+ * \fn double evaluerAnticipation(const Partie *partie, int profondeur)
+ * \brief Évalue une position en simulant tous les mouvements possibles jusqu'à une profondeur donnée.
+ *
+ * \param partie Position à évaluer.
+ * \param profondeur Nombre de mouvements restant à simuler.
+ * \return L'évaluation de la meilleure suite de mouvements.
+ */
+static double evaluerAnticipation(const Partie *partie, int profondeur)
+{
+    if (partie->collision) // Le serpent est mort
+    {
+        return SCORE_MORT;
+    }
+    if ((profondeur == 0) || (partieTerminee(partie))) // Évaluer la position atteinte
+    {
+        double evaluation = -distancePomme(partie, partie->lesX[0], partie->lesY[0]);
+        if (espaceLibre(partie, ESPACE_LIBRE_SUFFISANT) < ESPACE_LIBRE_SUFFISANT) // Éviter les impasses
+        {
+            evaluation -= LARGEUR_PLATEAU * HAUTEUR_PLATEAU;
+        }
+        return evaluation;
+    }
+    double meilleure = SCORE_MORT;
+    for (int d = 0; d < NOMBRE_DIRECTIONS; d++)
+    {
+        if (DIRECTIONS[d] != directionOpposee(partie->direction))
+        {
+            Partie copie = *partie; // Copie de la partie sur laquelle le mouvement est simulé
+            copie.affichage = false;
+            bool mangee = progresser(&copie, DIRECTIONS[d]); // La pomme suivante est inconnue : ne pas utiliser jouerTour()
+            double evaluation = evaluerAnticipation(&copie, profondeur - 1);
+            if (mangee && (evaluation > SCORE_MORT))
+            {
+                evaluation += 10.0 * LARGEUR_PLATEAU * HAUTEUR_PLATEAU * profondeur; // Manger tôt vaut mieux que manger tard
+            }
+            if (evaluation > meilleure)
+            {
+                meilleure = evaluation;
+            }
+        }
+    }
+    return meilleure;
+}
+
+/**
+ * \fn char botAnticipation(const Partie *partie)
+ * \brief Bot anticipation : simule PROFONDEUR_ANTICIPATION mouvements à l'avance et choisit la meilleure suite.
+ *
+ * \param partie Partie en cours.
+ * \return La direction choisie.
+ */
+char botAnticipation(const Partie *partie) // Simule plusieurs mouvements à l'avance
+{
+    Partie copie = *partie; // Copie de travail, ajustée pour les simulations
+    copie.affichage = false;
+    char choix = partie->direction;
+    double meilleure = SCORE_MORT - 1.0;
+    for (int d = 0; d < NOMBRE_DIRECTIONS; d++)
+    {
+        if (DIRECTIONS[d] != directionOpposee(partie->direction))
+        {
+            Partie suivante = copie;
+            bool mangee = progresser(&suivante, DIRECTIONS[d]);
+            double evaluation = evaluerAnticipation(&suivante, PROFONDEUR_ANTICIPATION - 1);
+            if (mangee && (evaluation > SCORE_MORT))
+            {
+                evaluation += 10.0 * LARGEUR_PLATEAU * HAUTEUR_PLATEAU * PROFONDEUR_ANTICIPATION;
+            }
+            if (evaluation > meilleure)
+            {
+                meilleure = evaluation;
+                choix = DIRECTIONS[d];
+            }
+        }
+    }
+    return choix;
+}
+
+/**
+ * \fn bool queueAtteignable(const Partie *partie)
+ * \brief Indique si la tête peut rejoindre la queue du serpent.
+ *
+ * Un serpent qui peut suivre sa queue ne peut pas être piégé par son propre corps.
+ *
+ * \param partie Partie en cours.
+ * \return true si un chemin relie la tête à la queue, false sinon.
+ */
+bool queueAtteignable(const Partie *partie) // Indique si la tête peut rejoindre la queue du serpent
+{
+    bool occupee[LARGEUR_TABLEAU_PLATEAU][HAUTEUR_TABLEAU_PLATEAU]; // Cases bloquées ou déjà visitées
+    int fileX[NOMBRE_CASES_TABLEAU]; // File du parcours en largeur
+    int fileY[NOMBRE_CASES_TABLEAU];
+    int debut = 0;
+    int fin = 0;
+    int xQueue = partie->lesX[partie->taille - 1];
+    int yQueue = partie->lesY[partie->taille - 1];
+    marquerCorps(partie, occupee);
+    fileX[fin] = partie->lesX[0];
+    fileY[fin] = partie->lesY[0];
+    fin++;
+    while (debut < fin) // Parcourir les cases accessibles jusqu'à la queue
+    {
+        int x = fileX[debut];
+        int y = fileY[debut];
+        debut++;
+        for (int d = 0; d < NOMBRE_DIRECTIONS; d++)
+        {
+            int xVoisin, yVoisin;
+            if (caseVoisine(partie, x, y, DIRECTIONS[d], &xVoisin, &yVoisin) && (occupee[xVoisin][yVoisin] == false))
+            {
+                if ((xVoisin == xQueue) && (yVoisin == yQueue)) // Queue atteinte
+                {
+                    return true;
+                }
+                occupee[xVoisin][yVoisin] = true;
+                fileX[fin] = xVoisin;
+                fileY[fin] = yVoisin;
+                fin++;
+            }
+        }
+    }
+    return false;
+}
+
+/**
+ * \fn char botPondere(const Partie *partie, const double poids[NOMBRE_POIDS])
+ * \brief Bot pondéré : choisit le mouvement qui maximise une somme pondérée de critères.
+ *
+ * Chaque mouvement possible est simulé sur une copie de la partie, puis évalué avec les critères
+ * distance à la pomme, espace libre autour de la tête, queue atteignable, pomme mangée et tout droit.
+ * Les poids peuvent être réglés à la main (POIDS_DEFAUT) ou par l'outil entrainement.
+ *
+ * \param partie Partie en cours.
+ * \param poids Poids de chaque critère.
+ * \return La direction choisie.
+ */
+char botPondere(const Partie *partie, const double poids[NOMBRE_POIDS]) // Choisit le mouvement qui maximise une somme pondérée de critères
+{
+    char choix = partie->direction;
+    double meilleure = SCORE_MORT;
+    for (int d = 0; d < NOMBRE_DIRECTIONS; d++)
+    {
+        if (DIRECTIONS[d] != directionOpposee(partie->direction))
+        {
+            Partie copie = *partie; // Copie de la partie sur laquelle le mouvement est simulé
+            copie.affichage = false;
+            bool mangee = progresser(&copie, DIRECTIONS[d]);
+            if (copie.collision == false)
+            {
+                double criteres[NOMBRE_POIDS] = {
+                    mangee ? 0.0 : distancePomme(&copie, copie.lesX[0], copie.lesY[0]),
+                    (double)espaceLibre(&copie, LIMITE_ESPACE_PONDERE) / LIMITE_ESPACE_PONDERE,
+                    queueAtteignable(&copie) ? 1.0 : 0.0,
+                    mangee ? 1.0 : 0.0,
+                    (DIRECTIONS[d] == partie->direction) ? 1.0 : 0.0,
+                };
+                double evaluation = 0.0;
+                for (int i = 0; i < NOMBRE_POIDS; i++)
+                {
+                    evaluation += poids[i] * criteres[i];
+                }
+                if (evaluation > meilleure)
+                {
+                    meilleure = evaluation;
+                    choix = DIRECTIONS[d];
+                }
+            }
+        }
+    }
+    return choix;
+}
+
+/**
+ * \fn bool chargerPoids(const char *chemin, double poids[NOMBRE_POIDS])
+ * \brief Lit les meilleurs poids enregistrés dans une sauvegarde de l'outil entrainement.
+ *
+ * Les poids sont lus sur la ligne commençant par "meilleur".
+ *
+ * \param chemin Chemin de la sauvegarde.
+ * \param poids Poids lus.
+ * \return true si les poids ont été lus, false sinon (poids inchangés).
+ */
+bool chargerPoids(const char *chemin, double poids[NOMBRE_POIDS]) // Lit les meilleurs poids enregistrés par l'outil entrainement
+{
+    FILE *fichier = fopen(chemin, "r");
+    char ligne[512];
+    bool trouve = false;
+    if (fichier == NULL)
+    {
+        return false;
+    }
+    while ((trouve == false) && (fgets(ligne, sizeof(ligne), fichier) != NULL))
+    {
+        double lus[NOMBRE_POIDS];
+        if (sscanf(ligne, "meilleur %lf %lf %lf %lf %lf", &lus[0], &lus[1], &lus[2], &lus[3], &lus[4]) == NOMBRE_POIDS)
+        {
+            for (int i = 0; i < NOMBRE_POIDS; i++)
+            {
+                poids[i] = lus[i];
+            }
+            trouve = true;
+        }
+    }
+    fclose(fichier);
+    return trouve;
+}
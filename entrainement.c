@@ -0,0 +1,526 @@
+/**
+* \page Entrainement
+* \brief Entraînement évolutionnaire des poids du bot pondéré, évalué en parallèle sur tous les cœurs.
+* \author Ewen THÉPOT
+*
+* Une population de jeux de poids est évaluée à chaque génération sur les mêmes parties (mêmes graines).
+* Les meilleurs individus sont conservés (élitisme), les autres sont remplacés par des enfants obtenus
+* par sélection par tournoi, croisement et mutation gaussienne.
+*
+* Après chaque génération, la population est enregistrée dans une sauvegarde : relancer l'outil avec la même
+* sauvegarde reprend l'entraînement là où il s'était arrêté ; une sauvegarde illisible ou incompatible arrête
+* l'outil au lieu d'être écrasée. La ligne "meilleur" de la sauvegarde peut être
+* donnée à l'outil tournament.
+*
+* Toute la mémoire est réservée au lancement : l'évaluation des générations n'alloue rien.
+* Les parties d'une génération sont préparées une seule fois dans des gabarits, puis chaque partie
+* jouée en est une simple copie (reinitialiserPartie()).
+*
+* Utilisation : ./entrainement [nombre de générations] [nombre de threads] [sauvegarde]
+*/
+
+#define SNAKE_SANS_MAIN // Réutiliser le moteur du jeu sans son programme principal
+#include "snake.c"
+#include "bots.c"
+
+#include <string.h>
+#include <math.h> // Pour la mutation gaussienne
+#include <pthread.h> // Pour évaluer la population en parallèle
+#include <stdatomic.h> // Pour distribuer les parties entre les threads
+#include <errno.h> // Pour distinguer une sauvegarde absente d'une sauvegarde illisible
+
+// ----------------------------- CONSTANTES -------------------------------------
+
+/**
+ *
+ * \def TAILLE_POPULATION
+ *
+ * \brief constante pour le nombre d'individus (jeux de poids) de la population
+ *
+ */
+#define TAILLE_POPULATION 32 // Nombre d'individus par génération
+
+/**
+ *
+ * \def PARTIES_PAR_INDIVIDU
+ *
+ * \brief constante pour le nombre de parties jouées par chaque individu à chaque génération
+ *
+ */
+#define PARTIES_PAR_INDIVIDU 16 // Nombre de parties pour évaluer un individu
+
+/**
+ *
+ * \def NOMBRE_PARTIES_GENERATION
+ *
+ * \brief constante pour le nombre de parties jouées à chaque génération
+ *
+ */
+#define NOMBRE_PARTIES_GENERATION (TAILLE_POPULATION * PARTIES_PAR_INDIVIDU) // Nombre de parties par génération
+
+/**
+ *
+ * \def NOMBRE_ELITES
+ *
+ * \brief constante pour le nombre de meilleurs individus conservés tels quels d'une génération à l'autre
+ *
+ */
+#define NOMBRE_ELITES 4 // Nombre d'individus conservés sans modification
+
+/**
+ *
+ * \def TAILLE_SELECTION
+ *
+ * \brief constante pour le nombre d'individus tirés lors de la sélection par tournoi d'un parent
+ *
+ */
+#define TAILLE_SELECTION 3 // Nombre d'individus comparés pour choisir un parent
+
+/**
+ *
+ * \def PROBABILITE_MUTATION
+ *
+ * \brief constante pour la probabilité de muter chaque poids d'un enfant
+ *
+ */
+#define PROBABILITE_MUTATION 0.3 // Probabilité de mutation d'un poids
+
+/**
+ *
+ * \def ECART_MUTATION
+ *
+ * \brief constante pour l'écart type relatif de la mutation gaussienne
+ *
+ */
+#define ECART_MUTATION 0.2 // Écart type de la mutation, relatif à la valeur du poids
+
+/**
+ *
+ * \def NOMBRE_GENERATIONS_DEFAUT
+ *
+ * \brief constante pour le nombre de générations évaluées par défaut
+ *
+ */
+#define NOMBRE_GENERATIONS_DEFAUT 20 // Nombre de générations par défaut
+
+/**
+ *
+ * \def GRAINE_ENTRAINEMENT
+ *
+ * \brief constante pour la graine des parties et de l'évolution d'un nouvel entraînement
+ *
+ * \details Les parties de la génération g utilisent les graines GRAINE_ENTRAINEMENT + g * PARTIES_PAR_INDIVIDU + k.
+ *
+ */
+#define GRAINE_ENTRAINEMENT 20241130 // Graine d'un nouvel entraînement
+
+/**
+ *
+ * \def SAUVEGARDE_DEFAUT
+ *
+ * \brief constante pour le chemin de la sauvegarde par défaut
+ *
+ */
+#define SAUVEGARDE_DEFAUT "entrainement.sav" // Sauvegarde de l'entraînement par défaut
+
+/**
+ *
+ * \def ENTETE_SAUVEGARDE
+ *
+ * \brief constante pour la première ligne d'une sauvegarde
+ *
+ */
+#define ENTETE_SAUVEGARDE "snake-entrainement 1" // Première ligne (format et version) d'une sauvegarde
+
+
+// ------------------------------- TYPES ----------------------------------------
+
+/**
+ *
+ * \struct Entrainement
+ *
+ * \brief État de l'entraînement, partagé entre le thread principal et les threads d'évaluation
+ *
+ */
+typedef struct
+{
+    double population[TAILLE_POPULATION][NOMBRE_POIDS]; // Poids de chaque individu de la génération courante
+    double aptitudes[NOMBRE_PARTIES_GENERATION]; // Résultat de chaque partie de la génération courante
+    Partie gabarits[PARTIES_PAR_INDIVIDU]; // Parties de la génération courante, communes à tous les individus
+    Niveau niveau; // Niveau commun à toutes les parties
+    double meilleur[NOMBRE_POIDS]; // Meilleurs poids rencontrés
+    double meilleureAptitude; // Aptitude des meilleurs poids
+    bool meilleurConnu; // Indique si une génération a déjà été évaluée
+    int generation; // Numéro de la génération courante
+    unsigned int graine; // Générateur aléatoire de l'évolution
+    atomic_int prochainePartie; // Indice de la prochaine partie à jouer dans la génération
+    bool arret; // Demande d'arrêt aux threads d'évaluation
+    pthread_barrier_t debutGeneration; // Les threads attendent ici le début de chaque génération
+    pthread_barrier_t finGeneration; // Le thread principal attend ici la fin de l'évaluation
+} Entrainement;
+
+
+// Prototypes des fonctions
+double aleatoireUniforme(unsigned int *graine); // Tire un réel uniforme dans [0, 1[
+double aleatoireGaussien(unsigned int *graine); // Tire un réel selon la loi normale centrée réduite
+void initPopulation(Entrainement *entrainement); // Crée la première génération autour des poids par défaut
+bool chargerSauvegarde(Entrainement *entrainement, const char *chemin); // Reprend un entraînement enregistré
+bool enregistrerSauvegarde(const Entrainement *entrainement, const char *chemin); // Enregistre l'entraînement
+void *evaluerGenerations(void *argument); // Fonction exécutée par chaque thread d'évaluation
+int choisirParent(const double aptitudes[TAILLE_POPULATION], unsigned int *graine); // Sélection par tournoi
+void generationSuivante(Entrainement *entrainement, const double aptitudes[TAILLE_POPULATION]); // Crée la génération suivante
+
+
+// Programme principal
+
+/**
+* \fn int main(int argc, char *argv[])
+* \brief Entraîne le bot pondéré pendant le nombre de générations demandé.
+*
+* \param argc Nombre d'arguments.
+* \param argv Arguments : nombre de générations, nombre de threads (tous les cœurs par défaut), sauvegarde.
+* \return 0 en cas de succès, une autre valeur en cas d'erreur.
+*/
+int main(int argc, char *argv[])
+{
+    static Entrainement entrainement; // État de l'entraînement (hors de la pile, réservé une seule fois)
+    int nombreGenerations = (argc > 1) ? atoi(argv[1]) : NOMBRE_GENERATIONS_DEFAUT; // Nombre de générations à évaluer
+    int nombreThreads = (argc > 2) ? atoi(argv[2]) : (int)sysconf(_SC_NPROCESSORS_ONLN); // Un thread par cœur par défaut
+    const char *sauvegarde = (argc > 3) ? argv[3] : SAUVEGARDE_DEFAUT;
+    if ((nombreGenerations <= 0) || (nombreThreads <= 0))
+    {
+        fprintf(stderr, "Utilisation : %s [nombre de générations] [nombre de threads] [sauvegarde]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    initNiveauStandard(&entrainement.niveau);
+    if (chargerSauvegarde(&entrainement, sauvegarde)) // Reprendre l'entraînement s'il existe
+    {
+        printf("Reprise de %s à la génération %d\n", sauvegarde, entrainement.generation);
+    }
+    else if (errno == ENOENT) // Pas encore de sauvegarde : nouvel entraînement
+    {
+        initPopulation(&entrainement);
+    }
+    else // Ne jamais écraser une sauvegarde illisible
+    {
+        fprintf(stderr, "Impossible de reprendre %s : %s\n", sauvegarde, (errno == EINVAL) ? "sauvegarde invalide ou incompatible" : strerror(errno));
+        return EXIT_FAILURE;
+    }
+    pthread_t threads[nombreThreads];
+    pthread_barrier_init(&entrainement.debutGeneration, NULL, nombreThreads + 1);
+    pthread_barrier_init(&entrainement.finGeneration, NULL, nombreThreads + 1);
+    for (int i = 0; i < nombreThreads; i++)
+    {
+        if (pthread_create(&threads[i], NULL, evaluerGenerations, &entrainement) != 0)
+        {
+            perror("pthread_create");
+            return EXIT_FAILURE;
+        }
+    }
+    for (int g = 0; g < nombreGenerations; g++)
+    {
+        struct timespec debut, fin;
+        double aptitudes[TAILLE_POPULATION] = {0}; // Aptitude moyenne de chaque individu
+        double moyenne = 0.0;
+        int meilleurIndividu = 0;
+        clock_gettime(CLOCK_MONOTONIC, &debut);
+        for (int k = 0; k < PARTIES_PAR_INDIVIDU; k++) // Préparer les parties de la génération
+        {
+            initPartie(&entrainement.gabarits[k], &entrainement.niveau, GRAINE_ENTRAINEMENT + entrainement.generation * PARTIES_PAR_INDIVIDU + k, false);
+        }
+        atomic_store(&entrainement.prochainePartie, 0);
+        pthread_barrier_wait(&entrainement.debutGeneration); // Lancer l'évaluation de la génération
+        pthread_barrier_wait(&entrainement.finGeneration); // Attendre la fin de l'évaluation
+        clock_gettime(CLOCK_MONOTONIC, &fin);
+        for (int i = 0; i < TAILLE_POPULATION; i++)
+        {
+            for (int k = 0; k < PARTIES_PAR_INDIVIDU; k++)
+            {
+                aptitudes[i] += entrainement.aptitudes[i * PARTIES_PAR_INDIVIDU + k] / PARTIES_PAR_INDIVIDU;
+            }
+            moyenne += aptitudes[i] / TAILLE_POPULATION;
+            if (aptitudes[i] > aptitudes[meilleurIndividu])
+            {
+                meilleurIndividu = i;
+            }
+        }
+        if ((entrainement.meilleurConnu == false) || (aptitudes[meilleurIndividu] >= entrainement.meilleureAptitude))
+        {
+            memcpy(entrainement.meilleur, entrainement.population[meilleurIndividu], sizeof(entrainement.meilleur));
+            entrainement.meilleureAptitude = aptitudes[meilleurIndividu];
+            entrainement.meilleurConnu = true;
+        }
+        printf("Génération %4d : meilleure %.4f, moyenne %.4f, %.1f parties/s, poids", entrainement.generation, aptitudes[meilleurIndividu], moyenne, NOMBRE_PARTIES_GENERATION / ((fin.tv_sec - debut.tv_sec) + (fin.tv_nsec - debut.tv_nsec) / 1e9));
+        for (int i = 0; i < NOMBRE_POIDS; i++)
+        {
+            printf(" %.3f", entrainement.population[meilleurIndividu][i]);
+        }
+        printf("\n");
+        fflush(stdout);
+        generationSuivante(&entrainement, aptitudes);
+        if (enregistrerSauvegarde(&entrainement, sauvegarde) == false)
+        {
+            perror(sauvegarde);
+        }
+    }
+    entrainement.arret = true; // Arrêter les threads d'évaluation
+    pthread_barrier_wait(&entrainement.debutGeneration);
+    for (int i = 0; i < nombreThreads; i++)
+    {
+        pthread_join(threads[i], NULL);
+    }
+    pthread_barrier_destroy(&entrainement.debutGeneration);
+    pthread_barrier_destroy(&entrainement.finGeneration);
+    return EXIT_SUCCESS;
+}
+
+
+// Fonctions
+
+/**
+ * \fn double aleatoireUniforme(unsigned int *graine)
+ * \brief Tire un réel uniforme dans [0, 1[.
+ *
+ * \param graine État du générateur aléatoire.
+ * \return Le réel tiré.
+ */
+double aleatoireUniforme(unsigned int *graine) // Tire un réel uniforme dans [0, 1[
+{
+    return rand_r(graine) / (RAND_MAX + 1.0);
+}
+
+/**
+ * \fn double aleatoireGaussien(unsigned int *graine)
+ * \brief Tire un réel selon la loi normale centrée réduite (méthode de Box-Muller).
+ *
+ * \param graine État du générateur aléatoire.
+ * \return Le réel tiré.
+ */
+double aleatoireGaussien(unsigned int *graine) // Tire un réel selon la loi normale centrée réduite
+{
+    double u = 1.0 - aleatoireUniforme(graine); // Dans ]0, 1] pour le logarithme
+    double v = aleatoireUniforme(graine);
+    return sqrt(-2.0 * log(u)) * cos(2.0 * M_PI * v);
+}
+
+/**
+ * \fn void initPopulation(Entrainement *entrainement)
+ * \brief Crée la première génération autour des poids par défaut.
+ *
+ * Le premier individu reprend exactement les poids par défaut, les autres en sont des mutations.
+ *
+ * \param entrainement Entraînement à initialiser.
+ */
+void initPopulation(Entrainement *entrainement) // Crée la première génération autour des poids par défaut
+{
+    entrainement->generation = 0;
+    entrainement->graine = GRAINE_ENTRAINEMENT;
+    entrainement->meilleurConnu = false;
+    for (int i = 0; i < TAILLE_POPULATION; i++)
+    {
+        for (int j = 0; j < NOMBRE_POIDS; j++)
+        {
+            double ecart = (i == 0) ? 0.0 : ECART_MUTATION * (fabs(POIDS_DEFAUT[j]) + 1.0) * aleatoireGaussien(&entrainement->graine);
+            entrainement->population[i][j] = POIDS_DEFAUT[j] + ecart;
+        }
+    }
+}
+
+/**
+ * \fn bool chargerSauvegarde(Entrainement *entrainement, const char *chemin)
+ * \brief Reprend un entraînement enregistré par enregistrerSauvegarde().
+ *
+ * \param entrainement Entraînement à remplir.
+ * \param chemin Chemin de la sauvegarde.
+ * \return true si la sauvegarde a été lue, false sinon : errno vaut alors ENOENT si elle n'existe pas,
+ * EINVAL si elle est invalide ou incompatible (autre taille de population), ou l'erreur de son ouverture.
+ */
+bool chargerSauvegarde(Entrainement *entrainement, const char *chemin) // Reprend un entraînement enregistré
+{
+    FILE *fichier = fopen(chemin, "r");
+    char ligne[512];
+    int individus = 0;
+    bool valide = true;
+    if (fichier == NULL)
+    {
+        return false;
+    }
+    entrainement->meilleurConnu = false;
+    valide = (fgets(ligne, sizeof(ligne), fichier) != NULL) && (strncmp(ligne, ENTETE_SAUVEGARDE, strlen(ENTETE_SAUVEGARDE)) == 0);
+    valide = valide && (fscanf(fichier, " generation %d graine %u", &entrainement->generation, &entrainement->graine) == 2);
+    while (valide && (fgets(ligne, sizeof(ligne), fichier) != NULL))
+    {
+        double poids[NOMBRE_POIDS];
+        if (sscanf(ligne, "meilleur %lf %lf %lf %lf %lf", &poids[0], &poids[1], &poids[2], &poids[3], &poids[4]) == NOMBRE_POIDS)
+        {
+            memcpy(entrainement->meilleur, poids, sizeof(poids));
+            entrainement->meilleurConnu = true;
+        }
+        else if (sscanf(ligne, "aptitude %lf", &entrainement->meilleureAptitude) == 1)
+        {
+            // Aptitude des meilleurs poids
+        }
+        else if (sscanf(ligne, "individu %lf %lf %lf %lf %lf", &poids[0], &poids[1], &poids[2], &poids[3], &poids[4]) == NOMBRE_POIDS)
+        {
+            valide = (individus < TAILLE_POPULATION);
+            if (valide)
+            {
+                memcpy(entrainement->population[individus], poids, sizeof(poids));
+                individus++;
+            }
+        }
+    }
+    fclose(fichier);
+    if (valide && (individus != TAILLE_POPULATION))
+    {
+        fprintf(stderr, "%s : %d individus au lieu de %d\n", chemin, individus, TAILLE_POPULATION);
+        valide = false;
+    }
+    errno = valide ? errno : EINVAL;
+    return valide;
+}
+
+/**
+ * \fn bool enregistrerSauvegarde(const Entrainement *entrainement, const char *chemin)
+ * \brief Enregistre l'entraînement (génération à évaluer, générateur aléatoire, meilleurs poids, population).
+ *
+ * La sauvegarde est d'abord écrite dans un fichier temporaire puis renommée : une interruption pendant
+ * l'écriture laisse la sauvegarde précédente intacte.
+ *
+ * \param entrainement Entraînement à enregistrer.
+ * \param chemin Chemin de la sauvegarde.
+ * \return true si la sauvegarde a été écrite, false sinon.
+ */
+bool enregistrerSauvegarde(const Entrainement *entrainement, const char *chemin) // Enregistre l'entraînement
+{
+    char temporaire[4096];
+    snprintf(temporaire, sizeof(temporaire), "%s.tmp", chemin);
+    FILE *fichier = fopen(temporaire, "w");
+    if (fichier == NULL)
+    {
+        return false;
+    }
+    fprintf(fichier, "%s\ngeneration %d\ngraine %u\n", ENTETE_SAUVEGARDE, entrainement->generation, entrainement->graine);
+    if (entrainement->meilleurConnu)
+    {
+        fprintf(fichier, "meilleur");
+        for (int j = 0; j < NOMBRE_POIDS; j++)
+        {
+            fprintf(fichier, " %.17g", entrainement->meilleur[j]);
+        }
+        fprintf(fichier, "\naptitude %.17g\n", entrainement->meilleureAptitude);
+    }
+    for (int i = 0; i < TAILLE_POPULATION; i++)
+    {
+        fprintf(fichier, "individu");
+        for (int j = 0; j < NOMBRE_POIDS; j++)
+        {
+            fprintf(fichier, " %.17g", entrainement->population[i][j]);
+        }
+        fprintf(fichier, "\n");
+    }
+    bool ecrit = (fflush(fichier) == 0) && (fsync(fileno(fichier)) == 0);
+    ecrit = (fclose(fichier) == 0) && ecrit;
+    return ecrit && (rename(temporaire, chemin) == 0);
+}
+
+/**
+ * \fn void *evaluerGenerations(void *argument)
+ * \brief Fonction exécutée par chaque thread d'évaluation.
+ *
+ * À chaque génération, le thread joue des parties de la population tant qu'il en reste, puis attend la génération suivante.
+ * Chaque partie est une copie d'un gabarit, sur la pile du thread : aucune allocation n'a lieu pendant l'évaluation.
+ *
+ * \param argument Pointeur vers l'entraînement.
+ * \return NULL.
+ */
+void *evaluerGenerations(void *argument) // Fonction exécutée par chaque thread d'évaluation
+{
+    Entrainement *entrainement = argument;
+    while (true)
+    {
+        pthread_barrier_wait(&entrainement->debutGeneration); // Attendre le début de la génération
+        if (entrainement->arret)
+        {
+            break;
+        }
+        int tache;
+        while ((tache = atomic_fetch_add(&entrainement->prochainePartie, 1)) < NOMBRE_PARTIES_GENERATION) // Prendre la prochaine partie à jouer
+        {
+            const double *poids = entrainement->population[tache / PARTIES_PAR_INDIVIDU];
+            Partie partie;
+            reinitialiserPartie(&partie, &entrainement->gabarits[tache % PARTIES_PAR_INDIVIDU]); // Mêmes parties pour tous les individus
+            while ((partieTerminee(&partie) == false) && (partie.tours < TOURS_MAX_PARTIE))
+            {
+                jouerTour(&partie, botPondere(&partie, poids));
+            }
+            entrainement->aptitudes[tache] = partie.score - (double)partie.tours / (TOURS_MAX_PARTIE + 1); // Les pommes d'abord, la rapidité ensuite
+        }
+        pthread_barrier_wait(&entrainement->finGeneration); // Signaler la fin de l'évaluation
+    }
+    return NULL;
+}
+
+/**
+ * \fn int choisirParent(const double aptitudes[TAILLE_POPULATION], unsigned int *graine)
+ * \brief Choisit un parent par sélection par tournoi : le meilleur de TAILLE_SELECTION individus tirés au hasard.
+ *
+ * \param aptitudes Aptitude de chaque individu.
+ * \param graine État du générateur aléatoire.
+ * \return L'indice du parent choisi.
+ */
+int choisirParent(const double aptitudes[TAILLE_POPULATION], unsigned int *graine) // Sélection par tournoi
+{
+    int choix = rand_r(graine) % TAILLE_POPULATION;
+    for (int i = 1; i < TAILLE_SELECTION; i++)
+    {
+        int candidat = rand_r(graine) % TAILLE_POPULATION;
+        if (aptitudes[candidat] > aptitudes[choix])
+        {
+            choix = candidat;
+        }
+    }
+    return choix;
+}
+
+/**
+ * \fn void generationSuivante(Entrainement *entrainement, const double aptitudes[TAILLE_POPULATION])
+ * \brief Crée la génération suivante : élites conservées, puis enfants par croisement et mutation.
+ *
+ * \param entrainement Entraînement dont la population est remplacée.
+ * \param aptitudes Aptitude de chaque individu de la génération évaluée.
+ */
+void generationSuivante(Entrainement *entrainement, const double aptitudes[TAILLE_POPULATION]) // Crée la génération suivante
+{
+    double suivante[TAILLE_POPULATION][NOMBRE_POIDS];
+    bool elite[TAILLE_POPULATION] = {false};
+    for (int e = 0; e < NOMBRE_ELITES; e++) // Conserver les meilleurs individus
+    {
+        int meilleur = -1;
+        for (int i = 0; i < TAILLE_POPULATION; i++)
+        {
+            if ((elite[i] == false) && ((meilleur < 0) || (aptitudes[i] > aptitudes[meilleur])))
+            {
+                meilleur = i;
+            }
+        }
+        elite[meilleur] = true;
+        memcpy(suivante[e], entrainement->population[meilleur], sizeof(suivante[e]));
+    }
+    for (int i = NOMBRE_ELITES; i < TAILLE_POPULATION; i++) // Compléter avec des enfants
+    {
+        const double *pere = entrainement->population[choisirParent(aptitudes, &entrainement->graine)];
+        const double *mere = entrainement->population[choisirParent(aptitudes, &entrainement->graine)];
+        for (int j = 0; j < NOMBRE_POIDS; j++)
+        {
+            double melange = 1.5 * aleatoireUniforme(&entrainement->graine) - 0.25; // Croisement par mélange, un peu au-delà des parents
+            suivante[i][j] = pere[j] + melange * (mere[j] - pere[j]);
+            if (aleatoireUniforme(&entrainement->graine) < PROBABILITE_MUTATION)
+            {
+                suivante[i][j] += ECART_MUTATION * (fabs(suivante[i][j]) + 1.0) * aleatoireGaussien(&entrainement->graine);
+            }
+        }
+    }
+    memcpy(entrainement->population, suivante, sizeof(suivante));
+    entrainement->generation++;
+}
@@ -0,0 +1,938 @@
+/**
+* \page Fuzzeur
+* \brief Test différentiel du moteur du jeu Snake contre une implémentation de référence.
+* \author Ewen THÉPOT
+*
+* Des parties aléatoires (graines et mouvements tirés au hasard) sont jouées en parallèle par la référence
+* et par le moteur du jeu (jouerTour() : progresser() et ajouterPomme()) ; l'empreinte de l'état (serpent, taille,
+* score, collision, pomme, générateur aléatoire) est comparée après chaque tour, et le plateau complet à la fin de chaque partie.
+*
+* La référence reprend mot pour mot l'ancienne fonction progresser() du jeu : déplacement de la tête,
+* collisions vérifiées avant le passage des issues, puis passage des issues, puis pomme mangée sur la case
+* atteinte après le passage. Sa pomme suit les règles de ajouterPomme(), mais la zone de la tête et ses cases
+* libres sont recalculées entièrement (parcours en largeur) à chaque pomme, sans aucun état incrémental.
+* Son état initial est construit sans initPartie() : plateau, issues, pavés et serpent sont placés à partir de la graine
+* et des constantes du jeu, puis la première pomme est tirée par la référence elle-même.
+*
+* À la première divergence, la partie est réduite par ddmin (morceaux de mouvements inutiles retirés, des moitiés aux mouvements seuls) jusqu'à un rejeu court,
+* affiché et enregistré dans FICHIER_REJEU ; ./fuzzeur -r <rejeu> le rejoue en détaillant la divergence.
+*
+* Utilisation : ./fuzzeur [nombre de parties] [nombre de threads] [première graine]
+*               ./fuzzeur -r <rejeu>
+*/
+
+#define SNAKE_SANS_MAIN // Réutiliser le moteur du jeu sans son programme principal
+#include "snake.c"
+
+#include <stdint.h>
+#include <pthread.h> // Pour jouer les parties en parallèle
+#include <stdatomic.h> // Pour distribuer les parties entre les threads
+
+// ----------------------------- CONSTANTES -------------------------------------
+
+/**
+ *
+ * \def NOMBRE_PARTIES_DEFAUT
+ *
+ * \brief constante pour le nombre de parties aléatoires jouées par défaut
+ *
+ */
+#define NOMBRE_PARTIES_DEFAUT 1000000 // Nombre de parties par défaut
+
+/**
+ *
+ * \def TOURS_MAX_FUZZ
+ *
+ * \brief constante pour le nombre maximum de tours d'une partie aléatoire
+ *
+ */
+#define TOURS_MAX_FUZZ 4000 // Nombre maximum de tours d'une partie
+
+/**
+ *
+ * \def FICHIER_REJEU
+ *
+ * \brief constante pour le fichier dans lequel le rejeu réduit d'une divergence est enregistré
+ *
+ */
+#define FICHIER_REJEU "divergence.rejeu" // Rejeu de la première divergence trouvée
+
+/**
+ *
+ * \def ENTETE_REJEU
+ *
+ * \brief constante pour la première ligne d'un fichier de rejeu
+ *
+ */
+#define ENTETE_REJEU "snake-rejeu 2" // Première ligne (format et version) d'un rejeu
+
+/**
+ *
+ * \def MOUVEMENT_INVALIDE
+ *
+ * \brief constante pour une touche qui n'est pas une direction, jouée de temps en temps par les parties aléatoires
+ *
+ */
+#define MOUVEMENT_INVALIDE 'x' // Touche qui n'est pas une direction
+
+
+// ------------------------------- TYPES ----------------------------------------
+
+/**
+ *
+ * \struct Reference
+ *
+ * \brief État d'une partie jouée par l'implémentation de référence
+ *
+ */
+typedef struct
+{
+    char coordPlateau[LARGEUR_TABLEAU_PLATEAU][HAUTEUR_TABLEAU_PLATEAU]; // Tableau des éléments du plateau
+    int lesX[TAILLE_MAX_SERPENT]; // Coordonnées X du serpent
+    int lesY[TAILLE_MAX_SERPENT]; // Coordonnées Y du serpent
+    int taille; // Taille actuelle du serpent
+    int score; // Nombre de pommes mangées
+    int xPomme; // Coordonnée X de la pomme courante
+    int yPomme; // Coordonnée Y de la pomme courante
+    char direction; // Direction du dernier mouvement
+    bool collision; // Indique si une collision a eu lieu
+    unsigned int graine; // État du générateur aléatoire de la partie
+} Reference;
+
+/**
+ *
+ * \struct Instantane
+ *
+ * \brief Vue commune de l'état d'une partie, quelle que soit l'implémentation qui la joue
+ *
+ */
+typedef struct
+{
+    const int *lesX; // Coordonnées X du serpent
+    const int *lesY; // Coordonnées Y du serpent
+    int taille; // Taille du serpent
+    int score; // Nombre de pommes mangées
+    int xPomme; // Coordonnée X de la pomme courante
+    int yPomme; // Coordonnée Y de la pomme courante
+    bool collision; // Indique si une collision a eu lieu
+    unsigned int graine; // État du générateur aléatoire (vérifie que les mêmes tirages ont été faits)
+} Instantane;
+
+/**
+ *
+ * \struct Statistiques
+ *
+ * \brief Ce que les parties aléatoires ont couvert
+ *
+ */
+typedef struct
+{
+    long parties; // Nombre de parties comparées
+    long tours; // Nombre de tours comparés
+    long pommes; // Nombre de pommes mangées
+    long issues; // Nombre de passages par une issue
+    long victoires; // Nombre de parties gagnées
+} Statistiques;
+
+/**
+ *
+ * \struct Campagne
+ *
+ * \brief Parties aléatoires partagées entre les threads, et première divergence trouvée
+ *
+ */
+typedef struct
+{
+    const Niveau *niveau; // Niveau des parties
+    long nombreParties; // Nombre de parties à jouer
+    unsigned int premiereGraine; // Graine de la première partie
+    atomic_long prochainePartie; // Indice de la prochaine partie à jouer
+    atomic_bool divergence; // Une divergence a été trouvée : les threads s'arrêtent
+    pthread_mutex_t verrou; // Protège les statistiques et la divergence
+    Statistiques statistiques; // Statistiques de toutes les parties
+    unsigned int graineDivergente; // Graine de la partie en désaccord
+    char mouvementsDivergents[TOURS_MAX_FUZZ]; // Mouvements de la partie en désaccord
+    int nombreMouvementsDivergents; // Nombre de mouvements de la partie en désaccord
+} Campagne;
+
+
+// Prototypes des fonctions
+void demarrerReference(Reference *reference, unsigned int graine); // Construit l'état initial de la référence à partir de la graine
+bool progresserReference(Reference *reference, char direction, bool *issue); // Ancienne fonction progresser() du jeu
+void ajouterPommeReference(Reference *reference); // Pomme de la référence, zone recalculée entièrement
+bool jouerReference(Reference *reference, char direction, bool *issue); // Joue un tour de la référence (score et nouvelle pomme)
+void decrireReference(const Reference *reference, Instantane *instantane); // Décrit l'état de la référence
+void decrirePartie(const Partie *partie, Instantane *instantane); // Décrit l'état d'une partie du jeu
+uint64_t empreinte(const Instantane *instantane); // Empreinte de l'état d'une partie
+bool instantaneTermine(const Instantane *instantane); // Indique si la partie décrite est terminée
+int distancePomme(int x, int y, int xPomme, int yPomme); // Distance à la pomme, issues comprises
+char choisirMouvement(const Reference *reference, unsigned int *alea); // Choisit le mouvement d'une partie aléatoire
+int comparerPartie(Partie *partie, const Partie *gabarit, unsigned int graine, char mouvements[], int *nombreMouvements, unsigned int *alea, Statistiques *statistiques); // Joue une partie avec la référence et le moteur du jeu
+int minimiserDivergence(Partie *partie, const Partie *gabarit, unsigned int graine, char mouvements[], int nombreMouvements); // Réduit les mouvements d'une divergence
+void *jouerCampagne(void *argument); // Fonction exécutée par chaque thread
+bool enregistrerRejeu(const char *chemin, unsigned int graine, const char mouvements[], int nombreMouvements); // Enregistre un rejeu
+int rejouer(const char *chemin, const Niveau *niveau); // Rejoue un rejeu en détaillant la divergence
+void afficherDivergence(Partie *partie, const Partie *gabarit, unsigned int graine, const char mouvements[], int divergence); // Détaille une divergence
+void afficherInstantane(const char *nom, const Instantane *instantane); // Affiche l'état d'une partie
+
+
+
+// Programme principal
+
+/**
+* \fn int main(int argc, char *argv[])
+* \brief Joue les parties aléatoires, puis réduit et enregistre la première divergence trouvée.
+*
+* \param argc Nombre d'arguments.
+* \param argv Arguments : nombre de parties, nombre de threads et première graine, ou -r et un fichier de rejeu.
+* \return 0 si le moteur du jeu ne diverge pas, une autre valeur sinon.
+*/
+int main(int argc, char *argv[])
+{
+    static Niveau niveau; // Niveau du jeu (table des déplacements)
+    static Campagne campagne; // Hors de la pile : contient les mouvements de la partie divergente
+    initNiveauStandard(&niveau);
+    if ((argc > 2) && (strcmp(argv[1], "-r") == 0))
+    {
+        return rejouer(argv[2], &niveau);
+    }
+    long nombreParties = (argc > 1) ? atol(argv[1]) : NOMBRE_PARTIES_DEFAUT;
+    int nombreThreads = (argc > 2) ? atoi(argv[2]) : (int)sysconf(_SC_NPROCESSORS_ONLN); // Un thread par cœur par défaut
+    if ((nombreParties <= 0) || (nombreThreads <= 0))
+    {
+        fprintf(stderr, "Utilisation : %s [nombre de parties] [nombre de threads] [première graine]\n       %s -r <rejeu>\n", argv[0], argv[0]);
+        return EXIT_FAILURE;
+    }
+    campagne.niveau = &niveau;
+    campagne.nombreParties = nombreParties;
+    campagne.premiereGraine = (argc > 3) ? (unsigned int)strtoul(argv[3], NULL, 10) : (unsigned int)time(NULL);
+    atomic_init(&campagne.prochainePartie, 0);
+    atomic_init(&campagne.divergence, false);
+    pthread_mutex_init(&campagne.verrou, NULL);
+    pthread_t *threads = malloc(sizeof(pthread_t) * nombreThreads);
+    struct timespec debut, fin;
+    clock_gettime(CLOCK_MONOTONIC, &debut);
+    for (int i = 0; i < nombreThreads; i++)
+    {
+        if (pthread_create(&threads[i], NULL, jouerCampagne, &campagne) != 0)
+        {
+            perror("pthread_create");
+            return EXIT_FAILURE;
+        }
+    }
+    for (int i = 0; i < nombreThreads; i++)
+    {
+        pthread_join(threads[i], NULL);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &fin);
+    double secondes = (fin.tv_sec - debut.tv_sec) + (fin.tv_nsec - debut.tv_nsec) / 1e9;
+    Statistiques *statistiques = &campagne.statistiques;
+    printf("%ld parties (graines %u et suivantes), %.2f s\n", statistiques->parties, campagne.premiereGraine, secondes);
+    printf("%ld tours comparés (%.0f tours/s), %ld pommes mangées, %ld passages d'issues, %ld parties gagnées\n",
+           statistiques->tours, statistiques->tours / secondes, statistiques->pommes, statistiques->issues, statistiques->victoires);
+    free(threads);
+    if (atomic_load(&campagne.divergence) == false)
+    {
+        printf("Aucune divergence\n");
+        return EXIT_SUCCESS;
+    }
+    // Réduire la divergence trouvée
+    static Partie gabarit, partie;
+    initPartie(&gabarit, &niveau, campagne.graineDivergente, false);
+    int nombreMouvements = minimiserDivergence(&partie, &gabarit, campagne.graineDivergente, campagne.mouvementsDivergents, campagne.nombreMouvementsDivergents);
+    printf("Divergence du moteur du jeu, graine %u : rejeu réduit de %d à %d mouvements\n", campagne.graineDivergente, campagne.nombreMouvementsDivergents, nombreMouvements);
+    printf("%.*s\n", nombreMouvements, campagne.mouvementsDivergents);
+    if (enregistrerRejeu(FICHIER_REJEU, campagne.graineDivergente, campagne.mouvementsDivergents, nombreMouvements))
+    {
+        printf("Rejeu enregistré dans %s (./%s -r %s)\n", FICHIER_REJEU, argv[0][0] == '.' ? argv[0] + 2 : argv[0], FICHIER_REJEU);
+    }
+    return EXIT_FAILURE;
+}
+
+
+// Fonctions
+
+/**
+ * \fn void demarrerReference(Reference *reference, unsigned int graine)
+ * \brief Construit l'état initial de la référence à partir de la graine, sans initPartie() ni les zones du jeu.
+ *
+ * Le plateau est tracé avec ses bordures et les quatre anciennes issues ; les pavés sont tirés comme au lancement du jeu
+ * (un pavé qui couvrirait le serpent initial est décalé vers le bas), puis la première pomme est ajoutée
+ * par ajouterPommeReference(). Un plateau, une pomme ou des tirages différents de ceux de initPartie() sont donc
+ * des divergences dès le premier tour.
+ *
+ * \param reference Référence à démarrer.
+ * \param graine Graine de la partie.
+ */
+void demarrerReference(Reference *reference, unsigned int graine) // Construit l'état initial de la référence à partir de la graine
+{
+    for (int x = 0; x < LARGEUR_TABLEAU_PLATEAU; x++) // Bordures, intérieur vide ; les rangs d'indice 0 restent vides
+    {
+        for (int y = 0; y < HAUTEUR_TABLEAU_PLATEAU; y++)
+        {
+            bool bordure = (x == X_BORDURE_GAUCHE_PLATEAU) || (x == X_BORDURE_DROITE_PLATEAU) || (y == Y_BORDURE_HAUT_PLATEAU) || (y == Y_BORDURE_BAS_PLATEAU);
+            reference->coordPlateau[x][y] = (bordure && (x > 0) && (y > 0)) ? CARACTERE_PLATEAU : CARACTERE_VIDE;
+        }
+    }
+    reference->coordPlateau[X_ISSUE_GAUCHE][Y_ISSUES_GAUCHE_DROITE] = CARACTERE_VIDE; // Anciennes issues
+    reference->coordPlateau[X_ISSUE_DROITE][Y_ISSUES_GAUCHE_DROITE] = CARACTERE_VIDE;
+    reference->coordPlateau[X_ISSUES_HAUT_BAS][Y_ISSUE_HAUT] = CARACTERE_VIDE;
+    reference->coordPlateau[X_ISSUES_HAUT_BAS][Y_ISSUE_BAS] = CARACTERE_VIDE;
+    reference->graine = graine;
+    for (int i = 0; i < NOMBRE_DE_PAVES; i++)
+    {
+        int x = (rand_r(&reference->graine) % ((X_MAX_PAVE + 1) - X_MIN_PAVE)) + X_MIN_PAVE;
+        int y = (rand_r(&reference->graine) % ((Y_MAX_PAVE + 1) - Y_MIN_PAVE)) + Y_MIN_PAVE;
+        if ((x <= X_INITIAL) && (x + TAILLE_PAVE - 1 >= X_INITIAL - (TAILLE_INITIALE_SERPENT - 1)) && (y <= Y_INITIAL) && (y + TAILLE_PAVE - 1 >= Y_INITIAL)) // Le pavé couvrirait le serpent
+        {
+            y += TAILLE_PAVE;
+        }
+        for (int j = 0; j < TAILLE_PAVE * TAILLE_PAVE; j++)
+        {
+            reference->coordPlateau[x + j / TAILLE_PAVE][y + j % TAILLE_PAVE] = CARACTERE_PAVE;
+        }
+    }
+    for (int i = 0; i < TAILLE_MAX_SERPENT; i++) // Serpent horizontal, la tête à droite
+    {
+        reference->lesX[i] = X_INITIAL - i;
+        reference->lesY[i] = Y_INITIAL;
+    }
+    reference->taille = TAILLE_INITIALE_SERPENT;
+    reference->score = 0;
+    reference->direction = DIRECTION_INITIALE;
+    reference->collision = false;
+    ajouterPommeReference(reference);
+}
+
+/**
+ * \fn bool progresserReference(Reference *reference, char direction, bool *issue)
+ * \brief Ancienne fonction progresser() du jeu, sans affichage.
+ *
+ * Les collisions sont vérifiées sur la case atteinte avant le passage des issues ; une case hors du tableau
+ * du plateau n'est jamais un obstacle. La pomme est mangée sur la case atteinte après le passage.
+ *
+ * \param reference Partie de référence.
+ * \param direction Direction du mouvement.
+ * \param issue Mis à true si la tête est passée par une issue.
+ * \return true si une pomme a été mangée, false sinon.
+ */
+bool progresserReference(Reference *reference, char direction, bool *issue) // Ancienne fonction progresser() du jeu
+{
+    bool mangee = false;
+    int *lesX = reference->lesX;
+    int *lesY = reference->lesY;
+    for (int i = (TAILLE_MAX_SERPENT - 1); i > 0; i--) // Faire évoluer chaque coordonnées du corps du serpent
+    {
+        lesX[i] = lesX[i - 1];
+        lesY[i] = lesY[i - 1];
+    }
+    if (direction == RIGHT)
+    {
+        lesX[0]++;
+    }
+    else if (direction == LEFT)
+    {
+        lesX[0]--;
+    }
+    else if (direction == UP)
+    {
+        lesY[0]--;
+    }
+    else if (direction == DOWN)
+    {
+        lesY[0]++;
+    }
+    reference->direction = direction;
+    for (int i = 1; i < reference->taille; i++) // Collisions entre la tête et le corps, avant le passage des issues
+    {
+        if ((lesX[i] == lesX[0]) && (lesY[i] == lesY[0]))
+        {
+            reference->collision = true;
+        }
+    }
+    if ((lesX[0] >= 0) && (lesX[0] < LARGEUR_TABLEAU_PLATEAU) && (lesY[0] >= 0) && (lesY[0] < HAUTEUR_TABLEAU_PLATEAU)
+        && ((reference->coordPlateau[lesX[0]][lesY[0]] == CARACTERE_PLATEAU) || (reference->coordPlateau[lesX[0]][lesY[0]] == CARACTERE_PAVE))) // Collisions avec un pavé ou une bordure
+    {
+        reference->collision = true;
+    }
+    *issue = true;
+    if ((lesX[0] > X_ISSUE_DROITE) && (lesY[0] == Y_ISSUES_GAUCHE_DROITE))
+    {
+        lesX[0] = X_ISSUE_GAUCHE;
+    }
+    else if ((lesX[0] < X_ISSUE_GAUCHE) && (lesY[0] == Y_ISSUES_GAUCHE_DROITE))
+    {
+        lesX[0] = X_ISSUE_DROITE;
+    }
+    else if ((lesX[0] == X_ISSUES_HAUT_BAS) && (lesY[0] < Y_ISSUE_HAUT))
+    {
+        lesY[0] = Y_ISSUE_BAS;
+    }
+    else if ((lesX[0] == X_ISSUES_HAUT_BAS) && (lesY[0] > Y_ISSUE_BAS))
+    {
+        lesY[0] = Y_ISSUE_HAUT;
+    }
+    else
+    {
+        *issue = false;
+    }
+    if (reference->coordPlateau[lesX[0]][lesY[0]] == POMME) // La pomme est mangée sur la case atteinte après le passage des issues
+    {
+        mangee = true;
+        reference->coordPlateau[lesX[0]][lesY[0]] = CARACTERE_VIDE;
+        reference->taille++; // Le nouveau segment est l'ancienne queue, déjà décalée
+    }
+    return mangee;
+}
+
+/**
+ * \fn void ajouterPommeReference(Reference *reference)
+ * \brief Ajoute une pomme selon les règles de ajouterPomme(), en recalculant entièrement la zone de la tête.
+ *
+ * La zone est parcourue en largeur depuis la tête avec les anciens déplacements (issues comprises),
+ * sans traverser le serpent : une poche fermée par le corps n'est pas accessible.
+ *
+ * \param reference Partie de référence.
+ */
+void ajouterPommeReference(Reference *reference) // Pomme de la référence, zone recalculée entièrement
+{
+    bool dansZone[LARGEUR_TABLEAU_PLATEAU][HAUTEUR_TABLEAU_PLATEAU] = {{false}};
+    bool surSerpent[LARGEUR_TABLEAU_PLATEAU][HAUTEUR_TABLEAU_PLATEAU] = {{false}};
+    int file[NOMBRE_CASES_TABLEAU]; // File du parcours en largeur (x * HAUTEUR_TABLEAU_PLATEAU + y)
+    int debut = 0;
+    int fin = 0;
+    int libres = 0;
+    int xTete = reference->lesX[0];
+    int yTete = reference->lesY[0];
+    for (int i = 0; i < reference->taille; i++)
+    {
+        surSerpent[reference->lesX[i]][reference->lesY[i]] = true;
+    }
+    if ((xTete >= X_BORDURE_GAUCHE_PLATEAU) && (xTete <= X_BORDURE_DROITE_PLATEAU) && (yTete >= Y_BORDURE_HAUT_PLATEAU) && (yTete <= Y_BORDURE_BAS_PLATEAU)
+        && (reference->coordPlateau[xTete][yTete] != CARACTERE_PLATEAU) && (reference->coordPlateau[xTete][yTete] != CARACTERE_PAVE))
+    {
+        dansZone[xTete][yTete] = true;
+        file[fin++] = xTete * HAUTEUR_TABLEAU_PLATEAU + yTete;
+    }
+    while (debut < fin)
+    {
+        int x = file[debut] / HAUTEUR_TABLEAU_PLATEAU;
+        int y = file[debut] % HAUTEUR_TABLEAU_PLATEAU;
+        const char directions[NOMBRE_DIRECTIONS] = {RIGHT, DOWN, LEFT, UP};
+        debut++;
+        libres += (surSerpent[x][y] == false);
+        for (int d = 0; d < NOMBRE_DIRECTIONS; d++)
+        {
+            int xVoisin = x + (directions[d] == RIGHT) - (directions[d] == LEFT);
+            int yVoisin = y + (directions[d] == DOWN) - (directions[d] == UP);
+            if ((xVoisin > X_ISSUE_DROITE) && (yVoisin == Y_ISSUES_GAUCHE_DROITE)) // Anciennes issues
+            {
+                xVoisin = X_ISSUE_GAUCHE;
+            }
+            else if ((xVoisin < X_ISSUE_GAUCHE) && (yVoisin == Y_ISSUES_GAUCHE_DROITE))
+            {
+                xVoisin = X_ISSUE_DROITE;
+            }
+            else if ((xVoisin == X_ISSUES_HAUT_BAS) && (yVoisin < Y_ISSUE_HAUT))
+            {
+                yVoisin = Y_ISSUE_BAS;
+            }
+            else if ((xVoisin == X_ISSUES_HAUT_BAS) && (yVoisin > Y_ISSUE_BAS))
+            {
+                yVoisin = Y_ISSUE_HAUT;
+            }
+            if ((xVoisin >= X_BORDURE_GAUCHE_PLATEAU) && (xVoisin <= X_BORDURE_DROITE_PLATEAU) && (yVoisin >= Y_BORDURE_HAUT_PLATEAU) && (yVoisin <= Y_BORDURE_BAS_PLATEAU)
+                && (dansZone[xVoisin][yVoisin] == false) && (surSerpent[xVoisin][yVoisin] == false) && (reference->coordPlateau[xVoisin][yVoisin] != CARACTERE_PLATEAU) && (reference->coordPlateau[xVoisin][yVoisin] != CARACTERE_PAVE))
+            {
+                dansZone[xVoisin][yVoisin] = true;
+                file[fin++] = xVoisin * HAUTEUR_TABLEAU_PLATEAU + yVoisin;
+            }
+        }
+    }
+    if (libres == 0) // Aucune case libre accessible : pas de pomme
+    {
+        return;
+    }
+    int x = 0;
+    int y = 0;
+    bool trouvee = false;
+    for (int essai = 0; (essai < ESSAIS_MAX_POMME) && (trouvee == false); essai++) // Tirages aléatoires
+    {
+        x = (rand_r(&reference->graine) % ((X_MAX_POMME + 1) - X_MIN_POMME)) + X_MIN_POMME;
+        y = (rand_r(&reference->graine) % ((Y_MAX_POMME + 1) - Y_MIN_POMME)) + Y_MIN_POMME;
+        trouvee = (reference->coordPlateau[x][y] == CARACTERE_VIDE) && (surSerpent[x][y] == false) && dansZone[x][y];
+    }
+    if (trouvee == false) // Case libre de la zone choisie par son rang, dans le cadre des tirages
+    {
+        int candidates = 0;
+        for (int i = X_MIN_POMME; i <= X_MAX_POMME; i++)
+        {
+            for (int j = Y_MIN_POMME; j <= Y_MAX_POMME; j++)
+            {
+                candidates += dansZone[i][j] && (surSerpent[i][j] == false);
+            }
+        }
+        if (candidates == 0) // Seules des issues restent libres : pas de pomme
+        {
+            return;
+        }
+        int rang = rand_r(&reference->graine) % candidates;
+        for (int i = X_MIN_POMME; (i <= X_MAX_POMME) && (trouvee == false); i++)
+        {
+            for (int j = Y_MIN_POMME; (j <= Y_MAX_POMME) && (trouvee == false); j++)
+            {
+                if (dansZone[i][j] && (surSerpent[i][j] == false))
+                {
+                    x = i;
+                    y = j;
+                    trouvee = (rang == 0);
+                    rang--;
+                }
+            }
+        }
+    }
+    reference->coordPlateau[x][y] = POMME;
+    reference->xPomme = x;
+    reference->yPomme = y;
+}
+
+/**
+ * \fn bool jouerReference(Reference *reference, char direction, bool *issue)
+ * \brief Joue un tour de la référence : mouvement, score et nouvelle pomme, comme jouerTour().
+ *
+ * \param reference Partie de référence.
+ * \param direction Direction du mouvement.
+ * \param issue Mis à true si la tête est passée par une issue.
+ * \return true si une pomme a été mangée, false sinon.
+ */
+bool jouerReference(Reference *reference, char direction, bool *issue) // Joue un tour de la référence (score et nouvelle pomme)
+{
+    bool mangee = progresserReference(reference, direction, issue);
+    if (mangee)
+    {
+        reference->score++;
+        if (reference->score < NOMBRE_DE_POMMES)
+        {
+            ajouterPommeReference(reference);
+        }
+    }
+    return mangee;
+}
+
+/**
+ * \fn void decrireReference(const Reference *reference, Instantane *instantane)
+ * \brief Décrit l'état de la référence.
+ *
+ * \param reference Partie de référence.
+ * \param instantane Description remplie.
+ */
+void decrireReference(const Reference *reference, Instantane *instantane) // Décrit l'état de la référence
+{
+    *instantane = (Instantane){reference->lesX, reference->lesY, reference->taille, reference->score, reference->xPomme, reference->yPomme, reference->collision, reference->graine};
+}
+
+/**
+ * \fn void decrirePartie(const Partie *partie, Instantane *instantane)
+ * \brief Décrit l'état d'une partie jouée par le moteur du jeu.
+ *
+ * \param partie Partie du jeu.
+ * \param instantane Description remplie.
+ */
+void decrirePartie(const Partie *partie, Instantane *instantane) // Décrit l'état d'une partie du jeu
+{
+    *instantane = (Instantane){partie->lesX, partie->lesY, partie->taille, partie->score, partie->xPomme, partie->yPomme, partie->collision, partie->graine};
+}
+
+/**
+ * \fn uint64_t empreinte(const Instantane *instantane)
+ * \brief Empreinte (FNV-1a) de l'état d'une partie, hors plateau : serpent, taille, score, collision, pomme et générateur.
+ *
+ * \param instantane État de la partie.
+ * \return L'empreinte.
+ */
+uint64_t empreinte(const Instantane *instantane) // Empreinte de l'état d'une partie
+{
+    uint64_t valeur = 14695981039346656037ULL;
+    int champs[] = {instantane->taille, instantane->score, instantane->xPomme, instantane->yPomme, instantane->collision, (int)instantane->graine};
+    for (int i = 0; i < instantane->taille; i++)
+    {
+        valeur = (valeur ^ (uint64_t)(instantane->lesX[i] * HAUTEUR_TABLEAU_PLATEAU + instantane->lesY[i])) * 1099511628211ULL;
+    }
+    for (int i = 0; i < (int)(sizeof(champs) / sizeof(champs[0])); i++)
+    {
+        valeur = (valeur ^ (uint32_t)champs[i]) * 1099511628211ULL;
+    }
+    return valeur;
+}
+
+/**
+ * \fn bool instantaneTermine(const Instantane *instantane)
+ * \brief Indique si la partie décrite est terminée, comme partieTerminee().
+ *
+ * \param instantane État de la partie.
+ * \return true en cas de collision ou de victoire.
+ */
+bool instantaneTermine(const Instantane *instantane) // Indique si la partie décrite est terminée
+{
+    return instantane->collision || (instantane->score == NOMBRE_DE_POMMES);
+}
+
+/**
+ * \fn int distancePomme(int x, int y, int xPomme, int yPomme)
+ * \brief Distance d'une case à la pomme, en passant éventuellement par une issue.
+ *
+ * \param x Coordonnée X de la case.
+ * \param y Coordonnée Y de la case.
+ * \param xPomme Coordonnée X de la pomme.
+ * \param yPomme Coordonnée Y de la pomme.
+ * \return Le plus petit nombre de mouvements sans tenir compte des obstacles.
+ */
+int distancePomme(int x, int y, int xPomme, int yPomme) // Distance à la pomme, issues comprises
+{
+    const int issues[4][4] = { // Case d'entrée, puis case atteinte après le passage
+        {X_ISSUE_DROITE, Y_ISSUES_GAUCHE_DROITE, X_ISSUE_GAUCHE, Y_ISSUES_GAUCHE_DROITE},
+        {X_ISSUE_GAUCHE, Y_ISSUES_GAUCHE_DROITE, X_ISSUE_DROITE, Y_ISSUES_GAUCHE_DROITE},
+        {X_ISSUES_HAUT_BAS, Y_ISSUE_HAUT, X_ISSUES_HAUT_BAS, Y_ISSUE_BAS},
+        {X_ISSUES_HAUT_BAS, Y_ISSUE_BAS, X_ISSUES_HAUT_BAS, Y_ISSUE_HAUT}};
+    int distance = abs(x - xPomme) + abs(y - yPomme);
+    for (int i = 0; i < 4; i++)
+    {
+        int parIssue = abs(x - issues[i][0]) + abs(y - issues[i][1]) + 1 + abs(issues[i][2] - xPomme) + abs(issues[i][3] - yPomme);
+        distance = (parIssue < distance) ? parIssue : distance;
+    }
+    return distance;
+}
+
+/**
+ * \fn char choisirMouvement(const Reference *reference, unsigned int *alea)
+ * \brief Choisit le mouvement d'une partie aléatoire.
+ *
+ * Le plus souvent, le serpent se rapproche de la pomme sans collision immédiate (pour jouer des parties longues,
+ * avec croissance et passages d'issues) ; parfois il tourne au hasard, fait demi-tour ou joue une touche invalide.
+ *
+ * \param reference Partie de référence.
+ * \param alea État du générateur aléatoire des mouvements.
+ * \return La touche jouée.
+ */
+char choisirMouvement(const Reference *reference, unsigned int *alea) // Choisit le mouvement d'une partie aléatoire
+{
+    const char directions[NOMBRE_DIRECTIONS] = {UP, DOWN, LEFT, RIGHT};
+    int tirage = rand_r(alea) % 256;
+    if (tirage == 0)
+    {
+        return MOUVEMENT_INVALIDE;
+    }
+    if (tirage < 3) // N'importe quelle direction, demi-tour compris
+    {
+        return directions[rand_r(alea) % NOMBRE_DIRECTIONS];
+    }
+    char choix = reference->direction;
+    int meilleureDistance = -1;
+    int depart = rand_r(alea) % NOMBRE_DIRECTIONS; // Départager les égalités au hasard
+    bool auHasard = (tirage < 48); // Direction sûre au hasard plutôt que la plus proche de la pomme
+    for (int k = 0; k < NOMBRE_DIRECTIONS; k++)
+    {
+        Reference suivante = *reference;
+        bool issue;
+        char direction = directions[(depart + k) % NOMBRE_DIRECTIONS];
+        suivante.coordPlateau[reference->xPomme][reference->yPomme] = CARACTERE_VIDE; // Ne pas manger la pomme pendant l'essai
+        progresserReference(&suivante, direction, &issue);
+        int distance = distancePomme(suivante.lesX[0], suivante.lesY[0], reference->xPomme, reference->yPomme);
+        if ((suivante.collision == false) && ((meilleureDistance < 0) || (auHasard == false && distance < meilleureDistance)))
+        {
+            meilleureDistance = distance;
+            choix = direction;
+        }
+    }
+    return choix;
+}
+
+/**
+ * \fn int comparerPartie(Partie *partie, const Partie *gabarit, unsigned int graine, char mouvements[], int *nombreMouvements, unsigned int *alea, Statistiques *statistiques)
+ * \brief Joue une partie avec la référence et le moteur du jeu (jouerTour()), et compare leurs états après chaque tour.
+ *
+ * Les empreintes sont comparées après chaque tour, les plateaux complets à la fin de la partie.
+ *
+ * \param partie Partie jouée par le moteur du jeu (écrasée par le gabarit).
+ * \param gabarit Partie préparée avec initPartie(), point de départ du moteur du jeu.
+ * \param graine Graine de la partie, point de départ de la référence.
+ * \param mouvements Mouvements joués ; remplis au fur et à mesure si alea n'est pas NULL.
+ * \param nombreMouvements Nombre de mouvements à rejouer ; mis à jour avec le nombre de mouvements joués si alea n'est pas NULL.
+ * \param alea Générateur des mouvements aléatoires, ou NULL pour rejouer les mouvements donnés.
+ * \param statistiques Statistiques à compléter, ou NULL.
+ * \return Le nombre de mouvements joués au moment de la divergence, -1 si le moteur du jeu et la référence sont d'accord.
+ */
+int comparerPartie(Partie *partie, const Partie *gabarit, unsigned int graine, char mouvements[], int *nombreMouvements, unsigned int *alea, Statistiques *statistiques) // Joue une partie avec la référence et le moteur du jeu
+{
+    Reference reference;
+    Instantane attendu, obtenu;
+    int tour = 0;
+    demarrerReference(&reference, graine);
+    reinitialiserPartie(partie, gabarit);
+    while (true)
+    {
+        decrireReference(&reference, &attendu);
+        decrirePartie(partie, &obtenu);
+        if (empreinte(&attendu) != empreinte(&obtenu))
+        {
+            *nombreMouvements = (alea != NULL) ? tour : *nombreMouvements;
+            return tour;
+        }
+        if (instantaneTermine(&attendu) || (tour == TOURS_MAX_FUZZ) || ((alea == NULL) && (tour == *nombreMouvements)))
+        {
+            break;
+        }
+        if (alea != NULL)
+        {
+            mouvements[tour] = choisirMouvement(&reference, alea);
+        }
+        bool issue;
+        bool mangee = jouerReference(&reference, mouvements[tour], &issue);
+        jouerTour(partie, mouvements[tour]);
+        tour++;
+        if (statistiques != NULL)
+        {
+            statistiques->pommes += mangee;
+            statistiques->issues += issue;
+        }
+    }
+    if (alea != NULL)
+    {
+        *nombreMouvements = tour;
+    }
+    if (statistiques != NULL)
+    {
+        statistiques->parties++;
+        statistiques->tours += tour;
+        statistiques->victoires += (attendu.score == NOMBRE_DE_POMMES);
+    }
+    if (memcmp(reference.coordPlateau, partie->coordPlateau, sizeof(reference.coordPlateau)) != 0) // Plateaux complets à la fin de la partie
+    {
+        return tour;
+    }
+    return -1;
+}
+
+/**
+ * \fn int minimiserDivergence(Partie *partie, const Partie *gabarit, unsigned int graine, char mouvements[], int nombreMouvements)
+ * \brief Réduit les mouvements d'une partie divergente tant qu'elle diverge encore (réduction delta : ddmin).
+ *
+ * Les mouvements qui suivent la divergence sont retirés, puis la partie est coupée en deux morceaux, dont chacun est
+ * retiré à tour de rôle. Si la partie raccourcie diverge toujours, elle est gardée (jusqu'à sa nouvelle divergence) et
+ * découpée un peu moins finement ; sinon les morceaux sont deux fois plus petits : moitiés, quarts... jusqu'aux mouvements
+ * seuls. La réduction s'arrête quand plus aucun mouvement seul ne peut être retiré.
+ *
+ * \param partie Partie jouée par le moteur du jeu.
+ * \param gabarit Partie préparée avec la graine divergente.
+ * \param graine Graine divergente.
+ * \param mouvements Mouvements de la partie, réduits sur place.
+ * \param nombreMouvements Nombre de mouvements de la partie.
+ * \return Le nombre de mouvements du rejeu réduit.
+ */
+int minimiserDivergence(Partie *partie, const Partie *gabarit, unsigned int graine, char mouvements[], int nombreMouvements) // Réduit les mouvements d'une divergence
+{
+    static char essai[TOURS_MAX_FUZZ]; // Mouvements sans un morceau (appelée par le seul thread principal)
+    int divergence = comparerPartie(partie, gabarit, graine, mouvements, &nombreMouvements, NULL, NULL);
+    int morceaux = 2; // Nombre de morceaux de la partie
+    if (divergence < 0)
+    {
+        return nombreMouvements;
+    }
+    nombreMouvements = divergence; // Les mouvements suivants sont inutiles
+    while (nombreMouvements > 0)
+    {
+        int longueur = (nombreMouvements + morceaux - 1) / morceaux; // Mouvements d'un morceau
+        bool reduit = false;
+        for (int debut = 0; (debut < nombreMouvements) && (reduit == false); debut += longueur) // Retirer le morceau qui commence à debut
+        {
+            int retires = (nombreMouvements - debut < longueur) ? nombreMouvements - debut : longueur;
+            int nombreEssai = nombreMouvements - retires;
+            memcpy(essai, mouvements, debut);
+            memcpy(essai + debut, mouvements + debut + retires, nombreEssai - debut);
+            divergence = comparerPartie(partie, gabarit, graine, essai, &nombreEssai, NULL, NULL);
+            if (divergence >= 0)
+            {
+                nombreMouvements = divergence;
+                memcpy(mouvements, essai, nombreMouvements);
+                reduit = true;
+            }
+        }
+        if (reduit) // Recommencer avec des morceaux un peu plus grands
+        {
+            morceaux = (morceaux > 2) ? morceaux - 1 : 2;
+        }
+        else if (morceaux >= nombreMouvements) // Aucun mouvement seul ne peut être retiré
+        {
+            break;
+        }
+        else // Morceaux deux fois plus petits
+        {
+            morceaux = (2 * morceaux < nombreMouvements) ? 2 * morceaux : nombreMouvements;
+        }
+    }
+    return nombreMouvements;
+}
+
+/**
+ * \fn void *jouerCampagne(void *argument)
+ * \brief Fonction exécutée par chaque thread : compare les parties aléatoires tant qu'il en reste et qu'aucune ne diverge.
+ *
+ * \param argument Pointeur vers la campagne.
+ * \return NULL.
+ */
+void *jouerCampagne(void *argument) // Fonction exécutée par chaque thread
+{
+    Campagne *campagne = argument;
+    Statistiques statistiques = {0};
+    Partie *gabarit = malloc(sizeof(Partie));
+    Partie *partie = malloc(sizeof(Partie));
+    char *mouvements = malloc(TOURS_MAX_FUZZ);
+    long indice;
+    while ((atomic_load(&campagne->divergence) == false) && ((indice = atomic_fetch_add(&campagne->prochainePartie, 1)) < campagne->nombreParties))
+    {
+        unsigned int graine = campagne->premiereGraine + (unsigned int)indice;
+        unsigned int alea = graine * 2654435761u; // Mouvements de la partie, tirés de sa graine
+        int nombreMouvements = 0;
+        initPartie(gabarit, campagne->niveau, graine, false);
+        if (comparerPartie(partie, gabarit, graine, mouvements, &nombreMouvements, &alea, &statistiques) >= 0)
+        {
+            pthread_mutex_lock(&campagne->verrou);
+            if (atomic_load(&campagne->divergence) == false) // Garder la première divergence
+            {
+                campagne->graineDivergente = graine;
+                memcpy(campagne->mouvementsDivergents, mouvements, nombreMouvements);
+                campagne->nombreMouvementsDivergents = nombreMouvements;
+                atomic_store(&campagne->divergence, true);
+            }
+            pthread_mutex_unlock(&campagne->verrou);
+        }
+    }
+    pthread_mutex_lock(&campagne->verrou);
+    campagne->statistiques.parties += statistiques.parties;
+    campagne->statistiques.tours += statistiques.tours;
+    campagne->statistiques.pommes += statistiques.pommes;
+    campagne->statistiques.issues += statistiques.issues;
+    campagne->statistiques.victoires += statistiques.victoires;
+    pthread_mutex_unlock(&campagne->verrou);
+    free(mouvements);
+    free(partie);
+    free(gabarit);
+    return NULL;
+}
+
+/**
+ * \fn bool enregistrerRejeu(const char *chemin, unsigned int graine, const char mouvements[], int nombreMouvements)
+ * \brief Enregistre un rejeu : en-tête, graine de la partie et mouvements.
+ *
+ * \param chemin Chemin du fichier.
+ * \param graine Graine de la partie.
+ * \param mouvements Mouvements du rejeu.
+ * \param nombreMouvements Nombre de mouvements.
+ * \return true si le rejeu a été enregistré, false sinon.
+ */
+bool enregistrerRejeu(const char *chemin, unsigned int graine, const char mouvements[], int nombreMouvements) // Enregistre un rejeu
+{
+    FILE *fichier = fopen(chemin, "w");
+    if (fichier == NULL)
+    {
+        return false;
+    }
+    fprintf(fichier, "%s\ngraine %u\nmouvements %.*s\n", ENTETE_REJEU, graine, nombreMouvements, mouvements);
+    return fclose(fichier) == 0;
+}
+
+/**
+ * \fn int rejouer(const char *chemin, const Niveau *niveau)
+ * \brief Rejoue un rejeu avec la référence et le moteur du jeu, et détaille l'état des deux au moment de la divergence.
+ *
+ * \param chemin Chemin du rejeu.
+ * \param niveau Niveau du jeu.
+ * \return 0 si le moteur du jeu est maintenant d'accord avec la référence, une autre valeur sinon.
+ */
+int rejouer(const char *chemin, const Niveau *niveau) // Rejoue un rejeu en détaillant la divergence
+{
+    static char mouvements[TOURS_MAX_FUZZ + 1];
+    static Partie gabarit, partie;
+    char entete[32] = "";
+    unsigned int graine = 0;
+    FILE *fichier = fopen(chemin, "r");
+    if ((fichier == NULL) || (fscanf(fichier, "%31[^\n] graine %u mouvements ", entete, &graine) != 2) || (strcmp(entete, ENTETE_REJEU) != 0))
+    {
+        fprintf(stderr, "Rejeu illisible : %s\n", chemin);
+        return EXIT_FAILURE;
+    }
+    if (fscanf(fichier, "%4000[^\n]", mouvements) != 1) // Rejeu sans mouvement
+    {
+        mouvements[0] = '\0';
+    }
+    fclose(fichier);
+    int nombreMouvements = strlen(mouvements);
+    initPartie(&gabarit, niveau, graine, false);
+    int divergence = comparerPartie(&partie, &gabarit, graine, mouvements, &nombreMouvements, NULL, NULL);
+    printf("Graine %u, %d mouvements : %s\n", graine, nombreMouvements, mouvements);
+    if (divergence < 0)
+    {
+        printf("Aucune divergence\n");
+    }
+    else
+    {
+        afficherDivergence(&partie, &gabarit, graine, mouvements, divergence);
+    }
+    return (divergence < 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/**
+ * \fn void afficherDivergence(Partie *partie, const Partie *gabarit, unsigned int graine, const char mouvements[], int divergence)
+ * \brief Rejoue une partie jusqu'à sa divergence, puis affiche l'état de la référence, celui du moteur du jeu et les cases qui diffèrent.
+ *
+ * \param partie Partie jouée par le moteur du jeu.
+ * \param gabarit Partie préparée.
+ * \param graine Graine de la partie.
+ * \param mouvements Mouvements de la partie.
+ * \param divergence Nombre de mouvements joués au moment de la divergence.
+ */
+void afficherDivergence(Partie *partie, const Partie *gabarit, unsigned int graine, const char mouvements[], int divergence) // Détaille une divergence
+{
+    Reference reference; // Rejouer jusqu'à la divergence pour afficher les deux états
+    Instantane attendu, obtenu;
+    demarrerReference(&reference, graine);
+    reinitialiserPartie(partie, gabarit);
+    for (int tour = 0; tour < divergence; tour++)
+    {
+        bool issue;
+        jouerReference(&reference, mouvements[tour], &issue);
+        jouerTour(partie, mouvements[tour]);
+    }
+    decrireReference(&reference, &attendu);
+    decrirePartie(partie, &obtenu);
+    printf("Divergence après %d mouvements (dernier : %c)\n", divergence, (divergence > 0) ? mouvements[divergence - 1] : '-');
+    afficherInstantane("référence", &attendu);
+    afficherInstantane("jeu", &obtenu);
+    for (int x = 0; x < LARGEUR_TABLEAU_PLATEAU; x++) // Cases du plateau qui diffèrent
+    {
+        for (int y = 0; y < HAUTEUR_TABLEAU_PLATEAU; y++)
+        {
+            if (reference.coordPlateau[x][y] != partie->coordPlateau[x][y])
+            {
+                printf("  case (%d, %d) : '%c' attendu, '%c' obtenu\n", x, y, reference.coordPlateau[x][y], partie->coordPlateau[x][y]);
+            }
+        }
+    }
+}
+
+/**
+ * \fn void afficherInstantane(const char *nom, const Instantane *instantane)
+ * \brief Affiche l'état d'une partie : taille, score, collision, pomme, générateur et segments du serpent.
+ *
+ * \param nom Nom de l'implémentation.
+ * \param instantane État de la partie.
+ */
+void afficherInstantane(const char *nom, const Instantane *instantane) // Affiche l'état d'une partie
+{
+    printf("  %-10s taille %d, score %d, collision %d, pomme (%d, %d), générateur %u, serpent", nom, instantane->taille, instantane->score, instantane->collision, instantane->xPomme, instantane->yPomme, instantane->graine);
+    for (int i = 0; i < instantane->taille; i++)
+    {
+        printf(" (%d, %d)", instantane->lesX[i], instantane->lesY[i]);
+    }
+    printf("\n");
+}
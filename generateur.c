@@ -0,0 +1,822 @@
+/**
+* \page Generateur
+* \brief Générateur de cartes d'obstacles pour le jeu Snake : labyrinthes, salles et obstacles aléatoires.
+* \author Ewen THÉPOT
+*
+* Les cartes générées ont des dimensions quelconques (jusqu'à plusieurs dizaines de milliers de cases de côté)
+* et leurs cases libres forment toujours une seule zone : toute case libre est accessible depuis n'importe quelle autre.
+*
+* - labyrinthe : labyrinthe parfait construit rangée par rangée (algorithme d'Eller, chaque ensemble de salles d'une rangée
+*   formant un anneau doublement chaîné), dont une proportion de murs peut ensuite être ouverte pour créer des boucles ;
+* - salles : une salle rectangulaire par bloc, blocs reliés par des couloirs selon un arbre couvrant aléatoire
+*   (algorithme de Kruskal, union-find sur les blocs) ;
+* - densite : obstacles tirés au hasard avec une densité donnée ; un obstacle n'est posé que si les cases libres
+*   qui l'entourent restent reliées entre elles sans lui, ce qui garantit que la zone libre n'est jamais coupée.
+*
+* La même graine donne toujours la même carte. La carte peut être enregistrée dans un fichier texte :
+* une ligne d'en-tête ENTETE_CARTE, une ligne "largeur hauteur", puis une ligne par rangée
+* ('#' pour un obstacle, '.' pour une case libre). L'option -c recharge une telle carte (pour la vérifier avec -v).
+* Le jeu, le tournoi et la suite de mesures ne chargent pas ces cartes : leur plateau reste celui de 80x40 cases du jeu,
+* fixé à la compilation, avec ses pavés tirés au hasard.
+*
+* Utilisation : ./generateur -t labyrinthe|salles|densite -l largeur -h hauteur [-g graine] [-d densité] [-o fichier] [-v]
+*               ./generateur -c carte [-o fichier] [-v]
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h> // Pour getopt
+
+// ----------------------------- CONSTANTES -------------------------------------
+
+/**
+ *
+ * \def OBSTACLE
+ *
+ * \brief constante pour la valeur d'une case occupée par un obstacle
+ *
+ */
+#define OBSTACLE 1 // Case occupée par un obstacle
+
+/**
+ *
+ * \def LIBRE
+ *
+ * \brief constante pour la valeur d'une case libre
+ *
+ */
+#define LIBRE 0 // Case libre
+
+/**
+ *
+ * \def CARACTERE_OBSTACLE
+ *
+ * \brief constante pour le caractère d'un obstacle dans un fichier de carte (le caractère des pavés du jeu)
+ *
+ */
+#define CARACTERE_OBSTACLE '#' // Obstacle dans un fichier de carte
+
+/**
+ *
+ * \def CARACTERE_LIBRE
+ *
+ * \brief constante pour le caractère d'une case libre dans un fichier de carte
+ *
+ */
+#define CARACTERE_LIBRE '.' // Case libre dans un fichier de carte
+
+/**
+ *
+ * \def ENTETE_CARTE
+ *
+ * \brief constante pour la première ligne d'un fichier de carte
+ *
+ */
+#define ENTETE_CARTE "snake-carte 1" // Première ligne (format et version) d'un fichier de carte
+
+/**
+ *
+ * \def TAILLE_BLOC_SALLES
+ *
+ * \brief constante pour la taille (en cases) du bloc carré contenant chaque salle
+ *
+ */
+#define TAILLE_BLOC_SALLES 12 // Côté d'un bloc de salle
+
+/**
+ *
+ * \def PROBABILITE_BOUCLE_SALLES
+ *
+ * \brief constante pour la probabilité d'ajouter un couloir entre deux salles déjà reliées
+ *
+ */
+#define PROBABILITE_BOUCLE_SALLES 0.1 // Couloirs supplémentaires créant des boucles
+
+/**
+ *
+ * \def DENSITE_DEFAUT_OBSTACLES
+ *
+ * \brief constante pour la densité d'obstacles par défaut d'une carte densite
+ *
+ */
+#define DENSITE_DEFAUT_OBSTACLES 0.3 // Densité d'obstacles par défaut
+
+/**
+ *
+ * \def DENSITE_DEFAUT_LABYRINTHE
+ *
+ * \brief constante pour la proportion de murs ouverts par défaut d'un labyrinthe (0 pour un labyrinthe parfait)
+ *
+ */
+#define DENSITE_DEFAUT_LABYRINTHE 0.0 // Labyrinthe parfait par défaut
+
+/**
+ *
+ * \def DENSITE_DEFAUT_SALLES
+ *
+ * \brief constante pour la taille relative des salles par défaut, par rapport à leur bloc
+ *
+ */
+#define DENSITE_DEFAUT_SALLES 0.6 // Taille relative des salles par défaut
+
+
+// ------------------------------- TYPES ----------------------------------------
+
+/**
+ *
+ * \struct Carte
+ *
+ * \brief Carte d'obstacles de dimensions quelconques
+ *
+ */
+typedef struct
+{
+    unsigned char *cases; // Cases de la carte, rangée par rangée (OBSTACLE ou LIBRE)
+    int largeur; // Nombre de colonnes
+    int hauteur; // Nombre de rangées
+} Carte;
+
+
+// Prototypes des fonctions
+uint64_t aleatoire(uint64_t *etat); // Générateur aléatoire rapide (xorshift64*)
+double aleatoireUniforme(uint64_t *etat); // Tire un réel uniforme dans [0, 1[
+int trouverRacine(int parents[], int element); // Trouve le représentant d'un ensemble (union-find)
+bool caseLibre(const Carte *carte, int x, int y); // Indique si une case est libre (les cases hors de la carte sont des obstacles)
+bool genererLabyrinthe(Carte *carte, uint64_t *etat, double ouverture); // Labyrinthe d'Eller, murs ouverts ensuite
+bool genererSalles(Carte *carte, uint64_t *etat, double tailleSalles); // Salles reliées par un arbre couvrant de couloirs
+unsigned anneauLibre(const Carte *carte, int x, int y); // Masque des cases libres autour de (x, y)
+bool obstacleSansCoupure(unsigned anneau); // Indique si un obstacle laisse reliées les cases libres voisines
+void genererObstacles(Carte *carte, uint64_t *etat, double densite); // Obstacles aléatoires qui ne coupent jamais la zone libre
+long compterZones(const Carte *carte); // Compte les zones de cases libres (vérification)
+bool enregistrerCarte(const Carte *carte, const char *chemin); // Enregistre la carte dans un fichier texte
+bool chargerCarte(Carte *carte, const char *chemin); // Charge une carte enregistrée dans un fichier texte
+double secondes(); // Horloge monotone en secondes
+
+
+// Programme principal
+
+/**
+* \fn int main(int argc, char *argv[])
+* \brief Génère une carte (ou charge une carte enregistrée), affiche ses statistiques et l'enregistre si un fichier est donné.
+*
+* \param argc Nombre d'arguments.
+* \param argv Options : -t type, -l largeur, -h hauteur, -g graine, -d densité, -c carte à charger, -o fichier, -v vérification.
+* \return 0 en cas de succès, une autre valeur en cas d'erreur.
+*/
+int main(int argc, char *argv[])
+{
+    const char *type = NULL; // Type de carte
+    const char *fichier = NULL; // Fichier de sortie
+    const char *source = NULL; // Carte à charger au lieu d'en générer une
+    long largeur = 0;
+    long hauteur = 0;
+    unsigned long graine = (unsigned long)time(NULL);
+    double densite = -1.0; // Densité par défaut du type de carte
+    bool verifier = false; // Compter les zones de la carte générée
+    int option;
+    while ((option = getopt(argc, argv, "t:l:h:g:d:c:o:v")) != -1)
+    {
+        switch (option)
+        {
+            case 't': type = optarg; break;
+            case 'l': largeur = atol(optarg); break;
+            case 'h': hauteur = atol(optarg); break;
+            case 'g': graine = strtoul(optarg, NULL, 10); break;
+            case 'd': densite = atof(optarg); break;
+            case 'c': source = optarg; break;
+            case 'o': fichier = optarg; break;
+            case 'v': verifier = true; break;
+            default: type = NULL; source = NULL; optind = argc; break;
+        }
+    }
+    if ((source == NULL) && ((type == NULL) || (largeur < 3) || (hauteur < 3) || (largeur * hauteur > 2000000000L) || (densite > 1.0)))
+    {
+        fprintf(stderr, "Utilisation : %s -t labyrinthe|salles|densite -l largeur -h hauteur [-g graine] [-d densité] [-o fichier] [-v]\n"
+                        "              %s -c carte [-o fichier] [-v]\n", argv[0], argv[0]);
+        return EXIT_FAILURE;
+    }
+    Carte carte = {NULL, 0, 0};
+    double debut = secondes();
+    if (source != NULL)
+    {
+        if (chargerCarte(&carte, source) == false)
+        {
+            fprintf(stderr, "%s : fichier illisible ou qui n'est pas une carte %s valide\n", source, ENTETE_CARTE);
+            return EXIT_FAILURE;
+        }
+        largeur = carte.largeur;
+        hauteur = carte.hauteur;
+    }
+    else
+    {
+        carte = (Carte){malloc((size_t)largeur * hauteur), (int)largeur, (int)hauteur};
+        if (carte.cases == NULL)
+        {
+            perror("malloc");
+            return EXIT_FAILURE;
+        }
+        uint64_t etat = graine * 0x9E3779B97F4A7C15ULL + 1; // État non nul du générateur aléatoire
+        bool generee = true; // La mémoire de travail du générateur a pu être réservée
+        if (strcmp(type, "labyrinthe") == 0)
+        {
+            generee = genererLabyrinthe(&carte, &etat, (densite < 0.0) ? DENSITE_DEFAUT_LABYRINTHE : densite);
+        }
+        else if (strcmp(type, "salles") == 0)
+        {
+            generee = genererSalles(&carte, &etat, (densite < 0.0) ? DENSITE_DEFAUT_SALLES : densite);
+        }
+        else if (strcmp(type, "densite") == 0)
+        {
+            genererObstacles(&carte, &etat, (densite < 0.0) ? DENSITE_DEFAUT_OBSTACLES : densite);
+        }
+        else
+        {
+            fprintf(stderr, "Type de carte inconnu : %s\n", type);
+            free(carte.cases);
+            return EXIT_FAILURE;
+        }
+        if (generee == false)
+        {
+            fprintf(stderr, "Mémoire insuffisante pour générer la carte\n");
+            free(carte.cases);
+            return EXIT_FAILURE;
+        }
+    }
+    double generation = secondes() - debut;
+    long obstacles = 0;
+    for (long i = 0; i < largeur * hauteur; i++)
+    {
+        obstacles += carte.cases[i];
+    }
+    if (source != NULL)
+    {
+        printf("Carte %s %ldx%ld : %.1f %% d'obstacles, chargée en %.3f s\n", source, largeur, hauteur, 100.0 * obstacles / (largeur * hauteur), generation);
+    }
+    else
+    {
+        printf("Carte %s %ldx%ld, graine %lu : %.1f %% d'obstacles, générée en %.3f s\n", type, largeur, hauteur, graine, 100.0 * obstacles / (largeur * hauteur), generation);
+    }
+    if (verifier)
+    {
+        long zones = compterZones(&carte);
+        if (zones < 0)
+        {
+            fprintf(stderr, "Mémoire insuffisante pour vérifier la carte\n");
+            free(carte.cases);
+            return EXIT_FAILURE;
+        }
+        printf("Zones de cases libres : %ld\n", zones);
+        if (zones != 1) // Zone libre coupée, ou aucune case libre
+        {
+            free(carte.cases);
+            return EXIT_FAILURE;
+        }
+    }
+    if (fichier != NULL)
+    {
+        debut = secondes();
+        if (enregistrerCarte(&carte, fichier) == false)
+        {
+            perror(fichier);
+            free(carte.cases);
+            return EXIT_FAILURE;
+        }
+        printf("Carte enregistrée dans %s en %.3f s\n", fichier, secondes() - debut);
+    }
+    free(carte.cases);
+    return EXIT_SUCCESS;
+}
+
+
+// Fonctions
+
+/**
+ * \fn uint64_t aleatoire(uint64_t *etat)
+ * \brief Générateur aléatoire rapide (xorshift64*), assez rapide pour tirer une valeur par case d'une très grande carte.
+ *
+ * \param etat État du générateur, jamais nul.
+ * \return Un entier aléatoire sur 64 bits.
+ */
+uint64_t aleatoire(uint64_t *etat) // Générateur aléatoire rapide (xorshift64*)
+{
+    *etat ^= *etat >> 12;
+    *etat ^= *etat << 25;
+    *etat ^= *etat >> 27;
+    return *etat * 0x2545F4914F6CDD1DULL;
+}
+
+/**
+ * \fn double aleatoireUniforme(uint64_t *etat)
+ * \brief Tire un réel uniforme dans [0, 1[.
+ *
+ * \param etat État du générateur.
+ * \return Le réel tiré.
+ */
+double aleatoireUniforme(uint64_t *etat) // Tire un réel uniforme dans [0, 1[
+{
+    return (aleatoire(etat) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+/**
+ * \fn int trouverRacine(int parents[], int element)
+ * \brief Trouve le représentant de l'ensemble contenant un élément (structure union-find), en raccourcissant les chemins.
+ *
+ * \param parents Parent de chaque élément.
+ * \param element Élément recherché.
+ * \return Le représentant de son ensemble.
+ */
+int trouverRacine(int parents[], int element) // Trouve le représentant d'un ensemble (union-find)
+{
+    while (parents[element] != element)
+    {
+        parents[element] = parents[parents[element]];
+        element = parents[element];
+    }
+    return element;
+}
+
+/**
+ * \fn bool caseLibre(const Carte *carte, int x, int y)
+ * \brief Indique si une case est libre ; les cases hors de la carte sont des obstacles.
+ *
+ * \param carte Carte.
+ * \param x Colonne.
+ * \param y Rangée.
+ * \return true si la case est libre.
+ */
+bool caseLibre(const Carte *carte, int x, int y) // Indique si une case est libre (les cases hors de la carte sont des obstacles)
+{
+    return (x >= 0) && (x < carte->largeur) && (y >= 0) && (y < carte->hauteur) && (carte->cases[(size_t)y * carte->largeur + x] == LIBRE);
+}
+
+/**
+ * \fn bool genererLabyrinthe(Carte *carte, uint64_t *etat, double ouverture)
+ * \brief Génère un labyrinthe parfait rangée par rangée (algorithme d'Eller), puis ouvre une partie des murs.
+ *
+ * Les salles du labyrinthe sont les cases de coordonnées impaires. Les salles d'un même ensemble de la rangée courante
+ * forment un anneau, de gauche à droite (gauche et droite) : deux ensembles ne se croisent jamais, donc deux salles
+ * voisines sont dans le même ensemble si et seulement si la première précède directement la seconde dans son anneau.
+ * Chaque rangée réunit au hasard des salles voisines d'ensembles différents (deux anneaux raccordés), puis une salle
+ * qui ne descend pas quitte son ensemble, sauf si elle en est la dernière : chaque ensemble descend au moins une fois.
+ * La dernière rangée réunit tous les ensembles restants. Chaque salle coûte un nombre constant d'opérations.
+ * Ouvrir un mur entre deux salles ne peut que relier davantage le labyrinthe.
+ *
+ * \param carte Carte à remplir.
+ * \param etat Générateur aléatoire.
+ * \param ouverture Proportion des murs intérieurs restants à ouvrir (0 pour un labyrinthe parfait).
+ * \return true si le labyrinthe a été généré, false si la mémoire manque.
+ */
+bool genererLabyrinthe(Carte *carte, uint64_t *etat, double ouverture) // Labyrinthe d'Eller, murs ouverts ensuite
+{
+    int colonnes = (carte->largeur - 1) / 2; // Nombre de salles par rangée
+    int rangees = (carte->hauteur - 1) / 2; // Nombre de rangées de salles
+    int *gauche = malloc(sizeof(int) * colonnes); // Salle précédente de l'ensemble, dans son anneau
+    int *droite = malloc(sizeof(int) * colonnes); // Salle suivante de l'ensemble, dans son anneau
+    size_t largeur = carte->largeur;
+    uint64_t bits = 0; // Réserve de tirages à pile ou face
+    if ((gauche == NULL) || (droite == NULL))
+    {
+        free(gauche);
+        free(droite);
+        return false;
+    }
+    memset(carte->cases, OBSTACLE, largeur * carte->hauteur);
+    for (int i = 0; i < colonnes; i++) // Première rangée : chaque salle forme son propre ensemble
+    {
+        gauche[i] = i;
+        droite[i] = i;
+    }
+    for (int j = 0; j < rangees; j++)
+    {
+        unsigned char *rangee = &carte->cases[(size_t)(2 * j + 1) * largeur]; // Rangée des salles
+        unsigned char *dessous = rangee + largeur; // Rangée des murs entre cette rangée de salles et la suivante
+        bool derniere = (j == rangees - 1);
+        for (int i = 0; i < colonnes; i++)
+        {
+            if ((i & 31) == 0)
+            {
+                bits = aleatoire(etat); // Deux tirages à pile ou face par salle, 32 salles par appel
+            }
+            rangee[2 * i + 1] = LIBRE;
+            if (i + 1 < colonnes) // Relier la salle à sa voisine de droite
+            {
+                bool relier = (droite[i] != i + 1) && (derniere || (bits & 1));
+                if (relier) // Raccorder les deux anneaux
+                {
+                    droite[gauche[i + 1]] = droite[i];
+                    gauche[droite[i]] = gauche[i + 1];
+                    droite[i] = i + 1;
+                    gauche[i + 1] = i;
+                }
+                rangee[2 * i + 2] = relier ? LIBRE : OBSTACLE;
+            }
+            if (derniere == false) // Descendre, ou quitter l'ensemble si une autre salle peut encore le faire descendre
+            {
+                bool descend = (droite[i] == i) || ((bits >> 1) & 1);
+                if (descend == false)
+                {
+                    droite[gauche[i]] = droite[i];
+                    gauche[droite[i]] = gauche[i];
+                    gauche[i] = i;
+                    droite[i] = i;
+                }
+                dessous[2 * i + 1] = descend ? LIBRE : OBSTACLE;
+            }
+            bits >>= 2;
+        }
+    }
+    if (ouverture > 0.0) // Ouvrir des murs pour créer des boucles
+    {
+        uint32_t seuil = (ouverture >= 1.0) ? 65536 : (uint32_t)(ouverture * 65536.0); // Tirages sur 16 bits, quatre par appel au générateur
+        int tirages = 0;
+        for (int y = 1; y < 2 * rangees; y++)
+        {
+            unsigned char *rangee = &carte->cases[(size_t)y * largeur];
+            for (int x = 1 + (y & 1); x < 2 * colonnes; x += 2) // Murs entre deux salles voisines
+            {
+                if ((tirages++ & 3) == 0)
+                {
+                    bits = aleatoire(etat);
+                }
+                rangee[x] = ((bits & 0xFFFF) < seuil) ? LIBRE : rangee[x]; // Ouvrir le mur (sans branchement)
+                bits >>= 16;
+            }
+        }
+    }
+    free(gauche);
+    free(droite);
+    return true;
+}
+
+/**
+ * \fn bool genererSalles(Carte *carte, uint64_t *etat, double tailleSalles)
+ * \brief Génère une salle par bloc, puis relie les blocs par des couloirs selon un arbre couvrant aléatoire.
+ *
+ * Les arêtes entre blocs voisins sont parcourues dans un ordre aléatoire (algorithme de Kruskal) : un couloir est
+ * creusé quand il relie deux ensembles différents, ou parfois pour créer une boucle. Tous les blocs finissent donc
+ * dans le même ensemble et toutes les salles sont reliées.
+ *
+ * \param carte Carte à remplir.
+ * \param etat Générateur aléatoire.
+ * \param tailleSalles Taille maximale d'une salle, relative à celle de son bloc.
+ * \return true si la carte a été générée, false si la mémoire manque.
+ */
+bool genererSalles(Carte *carte, uint64_t *etat, double tailleSalles) // Salles reliées par un arbre couvrant de couloirs
+{
+    int blocsX = carte->largeur / TAILLE_BLOC_SALLES; // Nombre de blocs par rangée
+    int blocsY = carte->hauteur / TAILLE_BLOC_SALLES; // Nombre de rangées de blocs
+    size_t largeur = carte->largeur;
+    memset(carte->cases, OBSTACLE, largeur * carte->hauteur);
+    if ((blocsX == 0) || (blocsY == 0)) // Carte trop petite pour des blocs : une seule salle
+    {
+        blocsX = 1;
+        blocsY = 1;
+    }
+    int tailleBlocX = carte->largeur / blocsX;
+    int tailleBlocY = carte->hauteur / blocsY;
+    int nombreBlocs = blocsX * blocsY;
+    int *centres = malloc(sizeof(int) * 2 * nombreBlocs); // Centre de la salle de chaque bloc (x puis y)
+    int *parents = malloc(sizeof(int) * nombreBlocs); // Union-find sur les blocs
+    int *aretes = malloc(sizeof(int) * 2 * nombreBlocs); // Arête vers la droite (2b) ou vers le bas (2b + 1)
+    int nombreAretes = 0;
+    if ((centres == NULL) || (parents == NULL) || (aretes == NULL))
+    {
+        free(centres);
+        free(parents);
+        free(aretes);
+        return false;
+    }
+    for (int by = 0; by < blocsY; by++) // Creuser une salle dans chaque bloc
+    {
+        for (int bx = 0; bx < blocsX; bx++)
+        {
+            int bloc = by * blocsX + bx;
+            int maxX = (int)((tailleBlocX - 2) * tailleSalles); // Taille maximale de la salle, sans toucher le bord du bloc
+            int maxY = (int)((tailleBlocY - 2) * tailleSalles);
+            int l = 1 + (maxX > 1 ? (int)(aleatoire(etat) % maxX) : 0);
+            int h = 1 + (maxY > 1 ? (int)(aleatoire(etat) % maxY) : 0);
+            int x0 = bx * tailleBlocX + 1 + (int)(aleatoire(etat) % (tailleBlocX - 1 - l));
+            int y0 = by * tailleBlocY + 1 + (int)(aleatoire(etat) % (tailleBlocY - 1 - h));
+            for (int y = y0; y < y0 + h; y++)
+            {
+                memset(&carte->cases[(size_t)y * largeur + x0], LIBRE, l);
+            }
+            centres[2 * bloc] = x0 + l / 2;
+            centres[2 * bloc + 1] = y0 + h / 2;
+            parents[bloc] = bloc;
+            if (bx + 1 < blocsX)
+            {
+                aretes[nombreAretes++] = 2 * bloc;
+            }
+            if (by + 1 < blocsY)
+            {
+                aretes[nombreAretes++] = 2 * bloc + 1;
+            }
+        }
+    }
+    for (int i = nombreAretes - 1; i > 0; i--) // Mélanger les arêtes (Fisher-Yates)
+    {
+        int j = (int)(aleatoire(etat) % (uint64_t)(i + 1));
+        int echange = aretes[i];
+        aretes[i] = aretes[j];
+        aretes[j] = echange;
+    }
+    for (int i = 0; i < nombreAretes; i++) // Creuser les couloirs de l'arbre couvrant
+    {
+        int a = aretes[i] / 2;
+        int b = (aretes[i] & 1) ? a + blocsX : a + 1;
+        int racineA = trouverRacine(parents, a);
+        int racineB = trouverRacine(parents, b);
+        if ((racineA != racineB) || (aleatoireUniforme(etat) < PROBABILITE_BOUCLE_SALLES))
+        {
+            int xa = centres[2 * a], ya = centres[2 * a + 1];
+            int xb = centres[2 * b], yb = centres[2 * b + 1];
+            int pas = (xb > xa) ? 1 : -1;
+            for (int x = xa; x != xb; x += pas) // Couloir horizontal puis vertical
+            {
+                carte->cases[(size_t)ya * largeur + x] = LIBRE;
+            }
+            pas = (yb > ya) ? 1 : -1;
+            for (int y = ya; y != yb + pas; y += pas)
+            {
+                carte->cases[(size_t)y * largeur + xb] = LIBRE;
+            }
+            parents[racineA] = racineB;
+        }
+    }
+    free(centres);
+    free(parents);
+    free(aretes);
+    return true;
+}
+
+/**
+ * \fn unsigned anneauLibre(const Carte *carte, int x, int y)
+ * \brief Calcule le masque des cases libres de l'anneau des huit cases autour de (x, y).
+ *
+ * L'anneau est parcouru dans l'ordre haut, haut-droite, droite, bas-droite, bas, bas-gauche, gauche, haut-gauche :
+ * deux cases consécutives se touchent et les bits pairs sont les voisines directes.
+ *
+ * \param carte Carte.
+ * \param x Colonne.
+ * \param y Rangée.
+ * \return Le masque sur 8 bits des cases libres de l'anneau.
+ */
+unsigned anneauLibre(const Carte *carte, int x, int y) // Masque des cases libres autour de (x, y)
+{
+    static const int dx[8] = {0, 1, 1, 1, 0, -1, -1, -1};
+    static const int dy[8] = {-1, -1, 0, 1, 1, 1, 0, -1};
+    unsigned anneau = 0;
+    for (int k = 0; k < 8; k++)
+    {
+        anneau |= (unsigned)caseLibre(carte, x + dx[k], y + dy[k]) << k;
+    }
+    return anneau;
+}
+
+/**
+ * \fn bool obstacleSansCoupure(unsigned anneau)
+ * \brief Indique si un obstacle laisse reliées les cases libres qui le touchent, d'après l'anneau qui l'entoure.
+ *
+ * Si toutes les voisines directes libres appartiennent à la même suite de cases libres de l'anneau, tout chemin
+ * passant par la case peut la contourner : l'obstacle ne coupe pas la zone libre.
+ *
+ * \param anneau Masque des cases libres de l'anneau (voir anneauLibre()).
+ * \return true si l'obstacle ne coupe pas la zone libre.
+ */
+bool obstacleSansCoupure(unsigned anneau) // Indique si un obstacle laisse reliées les cases libres voisines
+{
+    int depart = -1; // Une case bloquée de l'anneau, d'où commencer le parcours
+    for (int k = 0; k < 8; k++)
+    {
+        if (((anneau >> k) & 1) == 0)
+        {
+            depart = k;
+        }
+    }
+    if (depart < 0) // Anneau entièrement libre
+    {
+        return true;
+    }
+    int suites = 0; // Nombre de suites de cases libres contenant une voisine directe
+    bool voisineDansSuite = false;
+    for (int n = 1; n <= 8; n++)
+    {
+        int k = (depart + n) % 8;
+        if ((anneau >> k) & 1)
+        {
+            voisineDansSuite |= ((k % 2) == 0);
+        }
+        else
+        {
+            suites += voisineDansSuite;
+            voisineDansSuite = false;
+        }
+    }
+    return suites <= 1;
+}
+
+/**
+ * \fn void genererObstacles(Carte *carte, uint64_t *etat, double densite)
+ * \brief Pose des obstacles au hasard avec la densité demandée, sans jamais couper la zone libre.
+ *
+ * Chaque case tirée ne devient un obstacle que si obstacleSansCoupure() l'accepte ; la densité obtenue est donc
+ * un peu inférieure à la densité demandée lorsque celle-ci est forte. Les cases sont tirées rangée par rangée,
+ * de gauche à droite : autour d'une case intérieure, la case de droite et la rangée du dessous ne sont pas encore
+ * tirées, donc libres. Seules les trois cases du dessus et celle de gauche (gardée d'une case à l'autre) comptent, et le
+ * test est précalculé pour leurs seize valeurs possibles, dans un masque ; les cases du bord gardent le calcul complet de l'anneau.
+ *
+ * \param carte Carte à remplir.
+ * \param etat Générateur aléatoire.
+ * \param densite Probabilité qu'une case soit tirée comme obstacle.
+ */
+void genererObstacles(Carte *carte, uint64_t *etat, double densite) // Obstacles aléatoires qui ne coupent jamais la zone libre
+{
+    bool sansCoupure[256]; // Résultat de obstacleSansCoupure() pour chaque anneau
+    unsigned sansCoupureInterieure = 0; // Même résultat pour une case intérieure (bit lues, voir ci-dessous)
+    uint32_t seuil = (densite >= 1.0) ? 65536 : (uint32_t)(densite * 65536.0); // Tirages sur 16 bits, quatre par appel au générateur
+    uint64_t bits = 0;
+    long w = carte->largeur;
+    memset(carte->cases, LIBRE, (size_t)w * carte->hauteur);
+    for (unsigned anneau = 0; anneau < 256; anneau++)
+    {
+        sansCoupure[anneau] = obstacleSansCoupure(anneau);
+    }
+    for (unsigned lues = 0; lues < 16; lues++) // Bit 3 : haut-gauche, 2 : haut, 1 : haut-droite, 0 : gauche (1 si libre)
+    {
+        unsigned anneau = ((lues >> 2) & 1) | ((lues >> 1) & 1) << 1 | 0x38 | (lues & 1) << 6 | ((lues >> 3) & 1) << 7 | 1 << 2;
+        sansCoupureInterieure |= (unsigned)sansCoupure[anneau] << lues;
+    }
+    for (int y = 0; y < carte->hauteur; y++)
+    {
+        unsigned char *c = &carte->cases[(size_t)y * w];
+        bool interieure = (y > 0) && (y < carte->hauteur - 1);
+        unsigned gauche = 0; // Case de gauche libre (1) ou obstacle (0)
+        for (int x = 0; x < carte->largeur; x++)
+        {
+            if ((x & 3) == 0)
+            {
+                bits = aleatoire(etat);
+            }
+            unsigned tiree = ((bits >> (16 * (x & 3))) & 0xFFFF) < seuil;
+            if (interieure && (x > 0) && (x < carte->largeur - 1))
+            {
+                unsigned lues = (c[x - w - 1] == LIBRE) << 3 | (c[x - w] == LIBRE) << 2 | (c[x - w + 1] == LIBRE) << 1 | gauche;
+                unsigned obstacle = tiree & (sansCoupureInterieure >> lues); // Sans branchement
+                c[x] = obstacle ? OBSTACLE : LIBRE;
+                gauche = obstacle ^ 1;
+            }
+            else
+            {
+                c[x] = (tiree && sansCoupure[anneauLibre(carte, x, y)]) ? OBSTACLE : LIBRE;
+                gauche = (c[x] == LIBRE);
+            }
+        }
+    }
+}
+
+/**
+ * \fn long compterZones(const Carte *carte)
+ * \brief Compte les zones de cases libres de la carte (union-find sur toutes les cases), pour vérifier une carte générée.
+ *
+ * \param carte Carte.
+ * \return Le nombre de zones de cases libres, -1 si la mémoire manque.
+ */
+long compterZones(const Carte *carte) // Compte les zones de cases libres (vérification)
+{
+    size_t largeur = carte->largeur;
+    size_t nombreCases = largeur * carte->hauteur;
+    int *parents = malloc(sizeof(int) * nombreCases);
+    long zones = 0;
+    if (parents == NULL)
+    {
+        return -1;
+    }
+    for (size_t i = 0; i < nombreCases; i++)
+    {
+        parents[i] = (int)i;
+    }
+    for (size_t i = 0; i < nombreCases; i++) // Réunir chaque case libre avec ses voisines de droite et du dessous
+    {
+        if (carte->cases[i] == LIBRE)
+        {
+            if (((i % largeur) + 1 < largeur) && (carte->cases[i + 1] == LIBRE))
+            {
+                parents[trouverRacine(parents, (int)i)] = trouverRacine(parents, (int)(i + 1));
+            }
+            if ((i + largeur < nombreCases) && (carte->cases[i + largeur] == LIBRE))
+            {
+                parents[trouverRacine(parents, (int)i)] = trouverRacine(parents, (int)(i + largeur));
+            }
+        }
+    }
+    for (size_t i = 0; i < nombreCases; i++)
+    {
+        zones += (carte->cases[i] == LIBRE) && (parents[i] == (int)i);
+    }
+    free(parents);
+    return zones;
+}
+
+/**
+ * \fn bool enregistrerCarte(const Carte *carte, const char *chemin)
+ * \brief Enregistre la carte dans un fichier texte (en-tête, dimensions, puis une ligne par rangée).
+ *
+ * \param carte Carte à enregistrer.
+ * \param chemin Chemin du fichier.
+ * \return true si la carte a été enregistrée, false sinon.
+ */
+bool enregistrerCarte(const Carte *carte, const char *chemin) // Enregistre la carte dans un fichier texte
+{
+    FILE *fichier = fopen(chemin, "w");
+    char *ligne = malloc(carte->largeur + 1); // Une rangée, écrite d'un seul appel
+    bool ecrit = (fichier != NULL) && (ligne != NULL);
+    if (ecrit)
+    {
+        ecrit = fprintf(fichier, "%s\n%d %d\n", ENTETE_CARTE, carte->largeur, carte->hauteur) > 0;
+        ligne[carte->largeur] = '\n';
+        for (int y = 0; (y < carte->hauteur) && ecrit; y++)
+        {
+            const unsigned char *rangee = &carte->cases[(size_t)y * carte->largeur];
+            for (int x = 0; x < carte->largeur; x++)
+            {
+                ligne[x] = (rangee[x] == OBSTACLE) ? CARACTERE_OBSTACLE : CARACTERE_LIBRE;
+            }
+            ecrit = fwrite(ligne, 1, carte->largeur + 1, fichier) == (size_t)carte->largeur + 1;
+        }
+    }
+    if (fichier != NULL)
+    {
+        ecrit = (fclose(fichier) == 0) && ecrit;
+    }
+    free(ligne);
+    return ecrit;
+}
+
+/**
+ * \fn bool chargerCarte(Carte *carte, const char *chemin)
+ * \brief Charge une carte enregistrée par enregistrerCarte() (format ENTETE_CARTE), en vérifiant chaque rangée.
+ *
+ * \param carte Carte chargée ; ses cases sont allouées ici et doivent être libérées par l'appelant.
+ * \param chemin Chemin du fichier.
+ * \return true si la carte a été chargée, false si le fichier est illisible, mal formé ou si la mémoire manque.
+ */
+bool chargerCarte(Carte *carte, const char *chemin) // Charge une carte enregistrée dans un fichier texte
+{
+    FILE *fichier = fopen(chemin, "r");
+    char entete[sizeof(ENTETE_CARTE) + 1];
+    long largeur = 0;
+    long hauteur = 0;
+    char *ligne = NULL;
+    bool lu = (fichier != NULL) && (fgets(entete, sizeof(entete), fichier) != NULL) && (strcmp(entete, ENTETE_CARTE "\n") == 0)
+              && (fscanf(fichier, "%ld %ld", &largeur, &hauteur) == 2) && (fgetc(fichier) == '\n')
+              && (largeur > 0) && (hauteur > 0) && (largeur * hauteur <= 2000000000L);
+    carte->cases = NULL;
+    if (lu)
+    {
+        carte->largeur = (int)largeur;
+        carte->hauteur = (int)hauteur;
+        carte->cases = malloc((size_t)largeur * hauteur);
+        ligne = malloc(largeur + 1); // Une rangée, lue d'un seul appel
+        lu = (carte->cases != NULL) && (ligne != NULL);
+    }
+    for (long y = 0; (y < hauteur) && lu; y++)
+    {
+        unsigned char *rangee = &carte->cases[(size_t)y * largeur];
+        lu = (fread(ligne, 1, largeur + 1, fichier) == (size_t)largeur + 1) && (ligne[largeur] == '\n');
+        for (long x = 0; (x < largeur) && lu; x++)
+        {
+            rangee[x] = (ligne[x] == CARACTERE_OBSTACLE) ? OBSTACLE : LIBRE;
+            lu = (ligne[x] == CARACTERE_OBSTACLE) || (ligne[x] == CARACTERE_LIBRE);
+        }
+    }
+    lu = lu && (fgetc(fichier) == EOF); // Rien après la dernière rangée
+    if (fichier != NULL)
+    {
+        fclose(fichier);
+    }
+    free(ligne);
+    if (lu == false)
+    {
+        free(carte->cases);
+        carte->cases = NULL;
+    }
+    return lu;
+}
+
+/**
+ * \fn double secondes()
+ * \brief Horloge monotone en secondes.
+ *
+ * \return Le temps écoulé depuis une origine quelconque.
+ */
+double secondes() // Horloge monotone en secondes
+{
+    struct timespec instant;
+    clock_gettime(CLOCK_MONOTONIC, &instant);
+    return instant.tv_sec + instant.tv_nsec / 1e9;
+}
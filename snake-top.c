@@ -0,0 +1,253 @@
+/**
+* \page SnakeTop
+* \brief Surveillance des parties en cours à partir de l'état qu'elles publient en mémoire partagée.
+* \author Ewen THÉPOT
+*
+* Chaque jeu publie son état à chaque tour dans le segment /snake-<pid> (visible dans /dev/shm),
+* protégé par un verrou séquentiel : snake-top lit tous les segments sans jamais ralentir les jeux,
+* et n'affiche que des états cohérents. Un segment dont le jeu n'existe plus (jeu interrompu) est signalé.
+*
+* Utilisation : ./snake-top [période en ms] [nombre de rafraîchissements]
+*/
+
+#define SNAKE_SANS_MAIN // Réutiliser le format de l'état partagé sans le programme principal du jeu
+#include "snake.c"
+#include <dirent.h> // Pour parcourir les segments
+#include <signal.h> // Pour vérifier que le jeu existe encore
+
+// ----------------------------- CONSTANTES -------------------------------------
+
+/**
+ *
+ * \def PERIODE_TOP_DEFAUT
+ *
+ * \brief constante pour la période de rafraîchissement par défaut, en millisecondes
+ *
+ */
+#define PERIODE_TOP_DEFAUT 1000 // Rafraîchissement chaque seconde
+
+/**
+ *
+ * \def PARTIES_MAX_TOP
+ *
+ * \brief constante pour le nombre maximum de parties suivies
+ *
+ */
+#define PARTIES_MAX_TOP 256 // Nombre maximum de parties affichées
+
+/**
+ *
+ * \def REPERTOIRE_SEGMENTS
+ *
+ * \brief constante pour le répertoire où apparaissent les segments de mémoire partagée
+ *
+ */
+#define REPERTOIRE_SEGMENTS "/dev/shm" // Segments POSIX sous Linux
+
+
+// ------------------------------- TYPES ----------------------------------------
+
+/**
+ *
+ * \struct Suivi
+ *
+ * \brief Dernier état lu d'une partie, pour calculer sa vitesse au rafraîchissement suivant
+ *
+ */
+typedef struct
+{
+    int pid; // PID du jeu (0 : emplacement libre)
+    long tours; // Tours joués à la dernière lecture
+    long instant; // Instant de la dernière lecture, en nanosecondes
+    long rafraichissement; // Dernier rafraîchissement où la partie a été lue
+} Suivi;
+
+
+// Prototypes des fonctions
+bool lireSegment(const char *nom, int *pid, EtatPartie *etat); // Lit l'état cohérent d'un segment
+double toursParSeconde(Suivi suivis[], int pid, long tours, long instant, long rafraichissement); // Vitesse d'une partie depuis la lecture précédente
+void oublierParties(Suivi suivis[], long rafraichissement); // Libère les emplacements des parties disparues
+void afficherPartie(int pid, const EtatPartie *etat, double vitesse, long instant); // Affiche une ligne du tableau
+
+
+// Programme principal
+
+/**
+* \fn int main(int argc, char *argv[])
+* \brief Affiche périodiquement l'état de toutes les parties en cours.
+*
+* \param argc Nombre d'arguments.
+* \param argv Arguments : période en millisecondes, nombre de rafraîchissements (sans fin par défaut).
+* \return 0 en cas de succès, une autre valeur en cas d'erreur.
+*/
+int main(int argc, char *argv[])
+{
+    static Suivi suivis[PARTIES_MAX_TOP]; // Lectures précédentes
+    long periode = (argc > 1) ? atol(argv[1]) : PERIODE_TOP_DEFAUT;
+    long rafraichissements = (argc > 2) ? atol(argv[2]) : -1; // -1 : sans fin
+    if (periode <= 0)
+    {
+        fprintf(stderr, "Utilisation : %s [période en ms] [nombre de rafraîchissements]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    for (long r = 0; r != rafraichissements; r++)
+    {
+        DIR *repertoire = opendir(REPERTOIRE_SEGMENTS);
+        struct dirent *entree;
+        int parties = 0;
+        if (repertoire == NULL)
+        {
+            perror(REPERTOIRE_SEGMENTS);
+            return EXIT_FAILURE;
+        }
+        printf("\033[H\033[2J"); // Effacer le terminal
+        printf("%-8s %-9s %8s %8s %6s %6s %8s %9s %9s %9s %9s %9s %9s %8s\n", "PID", "État", "Tours", "Tours/s", "Taille", "Score", "Attente", "Tête", "Pomme", "Entrée", "Pas", "Diffusion", "Sommeil", "Durée");
+        while ((entree = readdir(repertoire)) != NULL)
+        {
+            char nom[LONGUEUR_NOM_ETAT + 1];
+            EtatPartie etat;
+            int pid;
+            if ((strncmp(entree->d_name, PREFIXE_ETAT_PARTAGE + 1, strlen(PREFIXE_ETAT_PARTAGE) - 1) != 0) || (strlen(entree->d_name) >= LONGUEUR_NOM_ETAT))
+            {
+                continue; // Pas un segment de partie
+            }
+            snprintf(nom, sizeof(nom), "/%s", entree->d_name);
+            if (lireSegment(nom, &pid, &etat))
+            {
+                long instant = nanosecondes();
+                afficherPartie(pid, &etat, toursParSeconde(suivis, pid, etat.tours, instant, r), instant);
+                parties++;
+            }
+        }
+        closedir(repertoire);
+        oublierParties(suivis, r);
+        printf("\n%d partie(s) en cours ; temps moyens par tour en µs\n", parties);
+        fflush(stdout);
+        if (r + 1 != rafraichissements)
+        {
+            usleep(periode * 1000);
+        }
+    }
+    return EXIT_SUCCESS;
+}
+
+
+// Fonctions
+
+/**
+ * \fn bool lireSegment(const char *nom, int *pid, EtatPartie *etat)
+ * \brief Projette un segment en lecture seule et en copie l'état sous le verrou séquentiel.
+ *
+ * \param nom Nom du segment (/snake-<pid>).
+ * \param pid PID du jeu qui publie le segment.
+ * \param etat État lu.
+ * \return true si le segment est valide et son état cohérent, false sinon.
+ */
+bool lireSegment(const char *nom, int *pid, EtatPartie *etat) // Lit l'état cohérent d'un segment
+{
+    struct stat informations;
+    bool lu = false;
+    int descripteur = shm_open(nom, O_RDONLY, 0);
+    if (descripteur < 0)
+    {
+        return false; // Partie terminée entre la lecture du répertoire et l'ouverture
+    }
+    if ((fstat(descripteur, &informations) == 0) && (informations.st_size == sizeof(SegmentEtat)))
+    {
+        const SegmentEtat *segment = mmap(NULL, sizeof(SegmentEtat), PROT_READ, MAP_SHARED, descripteur, 0);
+        if (segment != MAP_FAILED)
+        {
+            *pid = segment->pid;
+            lu = (segment->magie == MAGIE_ETAT_PARTAGE) && lireEtatPartage(segment, etat);
+            munmap((void *)segment, sizeof(SegmentEtat));
+        }
+    }
+    close(descripteur);
+    return lu;
+}
+
+/**
+ * \fn double toursParSeconde(Suivi suivis[], int pid, long tours, long instant, long rafraichissement)
+ * \brief Calcule la vitesse d'une partie depuis sa lecture précédente et mémorise la lecture courante.
+ *
+ * \param suivis Lectures précédentes.
+ * \param pid PID du jeu.
+ * \param tours Tours joués.
+ * \param instant Instant de la lecture, en nanosecondes.
+ * \param rafraichissement Numéro du rafraîchissement en cours.
+ * \return Le nombre de tours par seconde, ou -1 à la première lecture de la partie.
+ */
+double toursParSeconde(Suivi suivis[], int pid, long tours, long instant, long rafraichissement) // Vitesse d'une partie depuis la lecture précédente
+{
+    int libre = -1;
+    for (int i = 0; i < PARTIES_MAX_TOP; i++)
+    {
+        if ((suivis[i].pid == pid) && (tours < suivis[i].tours)) // PID réutilisé par un nouveau jeu entre deux rafraîchissements
+        {
+            suivis[i] = (Suivi){pid, tours, instant, rafraichissement};
+            return -1;
+        }
+        if (suivis[i].pid == pid)
+        {
+            double vitesse = 1e9 * (tours - suivis[i].tours) / (double)(instant - suivis[i].instant);
+            suivis[i].tours = tours;
+            suivis[i].instant = instant;
+            suivis[i].rafraichissement = rafraichissement;
+            return vitesse;
+        }
+        if ((suivis[i].pid == 0) && (libre < 0))
+        {
+            libre = i;
+        }
+    }
+    if (libre >= 0) // Première lecture de la partie (les parties au-delà de PARTIES_MAX_TOP n'ont pas de vitesse)
+    {
+        suivis[libre] = (Suivi){pid, tours, instant, rafraichissement};
+    }
+    return -1;
+}
+
+/**
+ * \fn void oublierParties(Suivi suivis[], long rafraichissement)
+ * \brief Libère les emplacements des parties qui n'ont pas été lues pendant le rafraîchissement en cours.
+ *
+ * Une partie terminée libère ainsi son emplacement, et un PID réutilisé par un nouveau jeu repart d'une lecture vierge.
+ *
+ * \param suivis Lectures précédentes.
+ * \param rafraichissement Numéro du rafraîchissement en cours.
+ */
+void oublierParties(Suivi suivis[], long rafraichissement) // Libère les emplacements des parties disparues
+{
+    for (int i = 0; i < PARTIES_MAX_TOP; i++)
+    {
+        if (suivis[i].rafraichissement != rafraichissement)
+        {
+            suivis[i].pid = 0;
+        }
+    }
+}
+
+/**
+ * \fn void afficherPartie(int pid, const EtatPartie *etat, double vitesse, long instant)
+ * \brief Affiche l'état d'une partie et le temps moyen de chaque phase de ses tours.
+ *
+ * \param pid PID du jeu.
+ * \param etat État lu.
+ * \param vitesse Tours par seconde (négatif si inconnu).
+ * \param instant Instant de la lecture, en nanosecondes.
+ */
+void afficherPartie(int pid, const EtatPartie *etat, double vitesse, long instant) // Affiche une ligne du tableau
+{
+    char tete[16], pomme[16], vitesseTexte[16];
+    double tours = (etat->tours > 0) ? etat->tours : 1;
+    bool vivant = (kill(pid, 0) == 0) || (errno == EPERM); // Le jeu existe encore (EPERM : jeu d'un autre utilisateur)
+    snprintf(tete, sizeof(tete), "%d,%d", etat->xTete, etat->yTete);
+    snprintf(pomme, sizeof(pomme), "%d,%d", etat->xPomme, etat->yPomme);
+    snprintf(vitesseTexte, sizeof(vitesseTexte), (vitesse >= 0) ? "%.1f" : "-", vitesse);
+    printf("%-8d %-9s %8ld %8s %6d %6d %6.1fms %9s %9s", pid, vivant ? "en cours" : "abandonné", etat->tours, vitesseTexte, etat->taille, etat->score, etat->tempsAttente / 1000.0, tete, pomme);
+    for (int phase = 0; phase < NOMBRE_PHASES; phase++)
+    {
+        printf(" %9.1f", etat->phases[phase] / tours / 1000.0);
+    }
+    printf(" %7.0fs\n", (instant - etat->debut) / 1e9);
+}
@@ -13,11 +13,19 @@
 // Importation des bibliothèques
 #include <stdlib.h>
 #include <stdio.h>
-#include <unistd.h> // Pour les fonctions sleep et kbhit
-#include <termios.h> // Pour la fonction kbhit
-#include <fcntl.h> // Pour la fonction kbhit
-#include <time.h> // Pour la fonction initPlateau
+#include <unistd.h> // Pour les fonctions sleep et read
+#include <termios.h> // Pour la lecture des touches
+#include <fcntl.h> // Pour la lecture des touches
+#include <time.h> // Pour la graine de la partie
 #include <stdbool.h> // Pour les collisions
+#include <string.h> // Pour la copie des parties
+#include <errno.h> // Pour la diffusion aux spectateurs
+#include <sys/socket.h> // Pour la diffusion aux spectateurs
+#include <sys/un.h> // Pour la diffusion aux spectateurs
+#include <stdint.h> // Pour l'état partagé
+#include <stdatomic.h> // Pour l'état partagé (verrou séquentiel)
+#include <sys/mman.h> // Pour l'état partagé
+#include <sys/stat.h> // Pour l'état partagé et la socket de diffusion
 
 // ----------------------------- CONSTANTES -------------------------------------
 
@@ -188,6 +196,26 @@
  */
 #define DIRECTION_INITIALE RIGHT; // Le serpent ira dans cette direction au lancement du jeu
 
+/**
+ * 
+ * \def FILE_TOUCHES_MAX
+ * 
+ * \brief constante pour le nombre maximum de virages en attente
+ * 
+ * \details Un virage est appliqué par tour : au-delà, les touches seraient jouées trop tard et sont ignorées.
+ * 
+ */
+#define FILE_TOUCHES_MAX 4 // Nombre maximum de virages en attente
+
+/**
+ * 
+ * \def LECTURE_TOUCHES_MAX
+ * 
+ * \brief constante pour le nombre d'octets lus à la fois dans le terminal
+ * 
+ */
+#define LECTURE_TOUCHES_MAX 64 // Taille du tampon de lecture des touches
+
 
 // Constantes utilisées lors de la création du plateau de jeu
 
@@ -427,6 +455,38 @@
  */
 #define Y_ISSUE_BAS Y_BORDURE_BAS_PLATEAU // Coordonée Y de l'issue du bas
 
+/**
+ * 
+ * \def PORTAILS_MAX
+ * 
+ * \brief constante pour le nombre maximum de portails d'un niveau (chaque portail relie deux issues)
+ * 
+ */
+#define PORTAILS_MAX 64 // Nombre maximum de portails d'un niveau (deux issues chacun)
+
+
+// Constantes utilisées pour les déplacements
+
+/**
+ * 
+ * \def NOMBRE_DIRECTIONS
+ * 
+ * \brief constante pour le nombre de directions possibles du serpent
+ * 
+ */
+#define NOMBRE_DIRECTIONS 4 // Haut, bas, gauche et droite
+
+/**
+ * 
+ * \def SANS_DIRECTION
+ * 
+ * \brief constante pour le code d'une touche qui n'est pas une direction (le serpent ne bouge pas)
+ * 
+ * \details Les directions UP, DOWN, LEFT et RIGHT ont les codes 1 à NOMBRE_DIRECTIONS, voir CODES_DIRECTIONS.
+ * 
+ */
+#define SANS_DIRECTION 0 // Code d'une touche qui n'est pas une direction
+
 
 // Constantes utilisées pour la création des pommes
 
@@ -475,6 +535,192 @@
  */
 #define Y_MAX_POMME (Y_BORDURE_BAS_PLATEAU - 1) // Coordonnée maximum Y de la pomme
 
+/**
+ * 
+ * \def ESSAIS_MAX_POMME
+ * 
+ * \brief constante pour le nombre de positions tirées au hasard avant de parcourir la zone de la tête
+ * 
+ * \details Lorsque la zone accessible depuis la tête est petite, les tirages sur tout le plateau échouent souvent :
+ * la pomme est alors choisie parmi les cases libres de la zone.
+ * 
+ */
+#define ESSAIS_MAX_POMME 64 // Nombre de tirages aléatoires avant de parcourir la zone de la tête
+
+
+// Constantes utilisées pour les zones du plateau
+
+/**
+ * 
+ * \def NOMBRE_CASES_TABLEAU
+ * 
+ * \brief constante pour le nombre de cases du tableau du plateau
+ * 
+ */
+#define NOMBRE_CASES_TABLEAU (LARGEUR_TABLEAU_PLATEAU * HAUTEUR_TABLEAU_PLATEAU) // Nombre de cases du tableau du plateau (rangs d'indice 0 compris)
+
+/**
+ * 
+ * \def NOMBRE_ZONES_MAX
+ * 
+ * \brief constante pour le nombre maximum de zones (composantes connexes) de cases libres
+ * 
+ * \details Deux zones distinctes ne se touchent pas : il y a au plus une zone pour deux cases.
+ * 
+ */
+#define NOMBRE_ZONES_MAX (NOMBRE_CASES_TABLEAU / 2 + 1) // Nombre maximum de zones du plateau
+
+/**
+ * 
+ * \def AUCUNE_ZONE
+ * 
+ * \brief constante pour la zone des cases qui n'appartiennent à aucune zone (bordures, pavés, serpent, hors plateau)
+ * 
+ */
+#define AUCUNE_ZONE (-1) // Zone d'une case bloquée
+
+
+// Constantes utilisées pour la diffusion de la partie aux spectateurs
+
+/**
+ * 
+ * \def SPECTATEURS_MAX
+ * 
+ * \brief constante pour le nombre maximum de spectateurs connectés en même temps
+ * 
+ */
+#define SPECTATEURS_MAX 64 // Nombre maximum de spectateurs
+
+/**
+ * 
+ * \def CHANGEMENTS_MAX_TOUR
+ * 
+ * \brief constante pour le nombre maximum de cases modifiées envoyées dans une trame de changements
+ * 
+ * \details Au-delà (dessin du plateau complet), les spectateurs reçoivent une image complète.
+ * 
+ */
+#define CHANGEMENTS_MAX_TOUR 256 // Nombre maximum de cases modifiées par tour
+
+/**
+ * 
+ * \def TAMPON_SPECTATEUR
+ * 
+ * \brief constante pour la taille (en octets) du tampon d'envoi vers chaque spectateur
+ * 
+ * \details Un spectateur dont le tampon est plein est en retard : ses trames sont abandonnées
+ * jusqu'à ce qu'il puisse recevoir une nouvelle image complète, sans jamais ralentir la partie.
+ * 
+ */
+#define TAMPON_SPECTATEUR 32768 // Tampon d'envoi par spectateur
+
+/**
+ * 
+ * \def TRAME_IMAGE
+ * 
+ * \brief constante pour le premier octet d'une trame contenant l'image complète du plateau
+ * 
+ * \details Trame : TRAME_IMAGE, numéro du tour (4 octets), largeur, hauteur, puis l'image
+ * compressée par plages (nombre de cases, caractère), rangée par rangée.
+ * 
+ */
+#define TRAME_IMAGE 'K' // Trame d'image complète
+
+/**
+ * 
+ * \def TRAME_CHANGEMENTS
+ * 
+ * \brief constante pour le premier octet d'une trame contenant les cases modifiées pendant un tour
+ * 
+ * \details Trame : TRAME_CHANGEMENTS, numéro du tour (4 octets), puis (x, y, caractère) pour chaque case modifiée.
+ * 
+ */
+#define TRAME_CHANGEMENTS 'D' // Trame de changements
+
+/**
+ * 
+ * \def TAILLE_TRAME_MAX
+ * 
+ * \brief constante pour la taille maximale (en octets) d'une trame
+ * 
+ */
+#define TAILLE_TRAME_MAX (7 + 2 * NOMBRE_CASES_TABLEAU) // Image complète sans aucune plage
+
+
+// Constantes utilisées pour publier l'état de la partie en mémoire partagée
+
+/**
+ * 
+ * \def PREFIXE_ETAT_PARTAGE
+ * 
+ * \brief constante pour le début du nom des segments de mémoire partagée des parties (suivi du PID du jeu)
+ * 
+ */
+#define PREFIXE_ETAT_PARTAGE "/snake-" // Nom d'un segment : /snake-<pid>, visible dans /dev/shm
+
+/**
+ * 
+ * \def MAGIE_ETAT_PARTAGE
+ * 
+ * \brief constante pour l'identifiant du format du segment (à changer si SegmentEtat change)
+ * 
+ */
+#define MAGIE_ETAT_PARTAGE 0x534E4B31 // "SNK1"
+
+/**
+ * 
+ * \def LONGUEUR_NOM_ETAT
+ * 
+ * \brief constante pour la longueur maximum du nom d'un segment
+ * 
+ */
+#define LONGUEUR_NOM_ETAT 32 // Longueur maximum d'un nom de segment, '\0' compris
+
+/**
+ * 
+ * \def NOMBRE_PHASES
+ * 
+ * \brief constante pour le nombre de phases chronométrées d'un tour
+ * 
+ */
+#define NOMBRE_PHASES 4 // Entrée, pas, diffusion, attente
+
+/**
+ * 
+ * \def PHASE_ENTREE
+ * 
+ * \brief constante pour la phase de lecture des touches
+ * 
+ */
+#define PHASE_ENTREE 0 // Lecture des touches
+
+/**
+ * 
+ * \def PHASE_PAS
+ * 
+ * \brief constante pour la phase de progression du serpent (dessin compris)
+ * 
+ */
+#define PHASE_PAS 1 // jouerTour()
+
+/**
+ * 
+ * \def PHASE_DIFFUSION
+ * 
+ * \brief constante pour la phase d'envoi aux spectateurs
+ * 
+ */
+#define PHASE_DIFFUSION 2 // diffuserTour()
+
+/**
+ * 
+ * \def PHASE_ATTENTE
+ * 
+ * \brief constante pour la phase d'attente entre deux tours
+ * 
+ */
+#define PHASE_ATTENTE 3 // usleep()
+
 
 // Gameplay
 
@@ -488,25 +734,275 @@
 #define MESSAGE_FIN "Snake un au revoir ;)\n" // Message de fin
 
 
+// ------------------------------- TYPES ----------------------------------------
+
+/**
+ *
+ * \struct Lien
+ *
+ * \brief Case atteinte en quittant une case dans une direction
+ *
+ */
+typedef struct
+{
+    unsigned char x; // Coordonnée X de la case atteinte
+    unsigned char y; // Coordonnée Y de la case atteinte
+    bool portail; // Le mouvement passe par un portail (aucune collision n'est possible pendant le passage)
+} Lien;
+
+/**
+ *
+ * \struct Portail
+ *
+ * \brief Paire de cases reliées : quitter l'une dans sa direction mène à l'autre, et inversement
+ *
+ */
+typedef struct
+{
+    int x1; // Coordonnée X de la première case
+    int y1; // Coordonnée Y de la première case
+    char direction1; // Direction par laquelle on quitte la première case vers la seconde
+    int x2; // Coordonnée X de la seconde case
+    int y2; // Coordonnée Y de la seconde case
+    char direction2; // Direction par laquelle on quitte la seconde case vers la première
+} Portail;
+
+/**
+ *
+ * \struct Niveau
+ *
+ * \brief Géométrie d'un niveau : case atteinte depuis chaque case dans chaque direction, portails compris
+ *
+ * \details La table des liens est calculée une fois par niveau : un mouvement est une seule lecture dans la table,
+ * sans test des bords ni des issues. Un niveau est partagé (en lecture seule) par toutes les parties qui s'y jouent.
+ *
+ */
+typedef struct Niveau
+{
+    Lien liens[LARGEUR_TABLEAU_PLATEAU][HAUTEUR_TABLEAU_PLATEAU][NOMBRE_DIRECTIONS + 1]; // Case atteinte depuis chaque case pour chaque code de direction
+    Portail portails[PORTAILS_MAX]; // Portails du niveau
+    int nombrePortails; // Nombre de portails du niveau
+    bool geometrique[LARGEUR_TABLEAU_PLATEAU][HAUTEUR_TABLEAU_PLATEAU]; // Case loin du bord du tableau et sans portail : ses déplacements mènent aux cases voisines
+    unsigned char groupesAnneau[512]; // Pour chaque ensemble de cases libres des trois colonnes autour d'une case, première voisine de chaque groupe de voisines reliées (bit k : case k de ANNEAU_X/ANNEAU_Y)
+} Niveau;
+
+/**
+ *
+ * \struct Partie
+ *
+ * \brief État complet d'une partie de Snake
+ *
+ * \details Regroupe le plateau, le serpent, la pomme et le générateur aléatoire de la partie.
+ * Le jeu et les outils de simulation (tournoi des bots) utilisent la même structure et les mêmes
+ * fonctions progresser() et ajouterPomme() : seul le champ affichage les distingue.
+ *
+ */
+typedef struct
+{
+    char coordPlateau[LARGEUR_TABLEAU_PLATEAU][HAUTEUR_TABLEAU_PLATEAU]; // Tableau des éléments du plateau (bordures, pavés, pomme, vide)
+    int lesX[TAILLE_MAX_SERPENT]; // Tableau des coordonnées X du serpent
+    int lesY[TAILLE_MAX_SERPENT]; // Tableau des coordonnées Y du serpent
+    int taille; // Taille actuelle du serpent
+    int score; // Nombre de pommes mangées
+    int xPomme; // Coordonnée X de la pomme courante
+    int yPomme; // Coordonnée Y de la pomme courante
+    short zone[LARGEUR_TABLEAU_PLATEAU][HAUTEUR_TABLEAU_PLATEAU]; // Zone (composante connexe des cases libres : ni obstacle ni serpent, issues comprises) de chaque case
+    unsigned char occupation[LARGEUR_TABLEAU_PLATEAU][HAUTEUR_TABLEAU_PLATEAU]; // Nombre de segments du serpent sur chaque case
+    short libresZone[NOMBRE_ZONES_MAX]; // Nombre de cases de chaque zone (0 : numéro de zone inutilisé)
+    uint64_t libresColonne[LARGEUR_TABLEAU_PLATEAU]; // Cases libres de chaque colonne (bit y : la case a une zone)
+    long tours; // Nombre de mouvements joués depuis le début de la partie
+    char direction; // Direction du dernier mouvement
+    bool collision; // Indique si une collision a eu lieu
+    bool affichage; // Indique si la partie est dessinée dans le terminal
+    unsigned int graine; // État du générateur aléatoire propre à la partie (reproductible et utilisable par plusieurs threads)
+    const Niveau *niveau; // Niveau (déplacements et portails) sur lequel la partie se joue
+} Partie;
+_Static_assert(HAUTEUR_TABLEAU_PLATEAU <= 64, "Une colonne du tableau du plateau doit tenir dans Partie::libresColonne");
+
+/**
+ *
+ * \struct PoolParties
+ *
+ * \brief Réserve de parties allouée une seule fois puis recyclée
+ *
+ * \details Les outils de simulation prennent et rendent leurs parties dans la réserve au lieu de les allouer.
+ * Une réserve n'est pas protégée contre les accès concurrents : elle est remplie et vidée par un seul thread.
+ *
+ */
+typedef struct
+{
+    Partie *parties; // Parties de la réserve, contiguës en mémoire
+    Partie **libres; // Pile des parties disponibles
+    int nombreLibres; // Nombre de parties disponibles
+    int capacite; // Nombre total de parties de la réserve
+} PoolParties;
+
+/**
+ *
+ * \struct Diffusion
+ *
+ * \brief Diffusion de la partie affichée aux spectateurs connectés à une socket locale
+ *
+ * \details afficher() et effacer() tiennent à jour une copie de l'écran et la liste des cases modifiées
+ * depuis le dernier tour ; diffuserTour() envoie ces changements à chaque spectateur, ou une image complète
+ * aux nouveaux spectateurs et à ceux qui ont pris du retard.
+ *
+ */
+typedef struct
+{
+    int serveur; // Socket d'écoute, -1 si la partie n'est pas diffusée
+    const char *chemin; // Chemin de la socket
+    int spectateurs[SPECTATEURS_MAX]; // Sockets des spectateurs connectés
+    bool enRetard[SPECTATEURS_MAX]; // Le spectateur attend une image complète
+    int nombreSpectateurs; // Nombre de spectateurs connectés
+    char ecran[LARGEUR_TABLEAU_PLATEAU][HAUTEUR_TABLEAU_PLATEAU]; // Copie de ce qui est affiché dans le terminal
+    unsigned char changements[3 * CHANGEMENTS_MAX_TOUR]; // Cases modifiées depuis le dernier tour (x, y, caractère)
+    int nombreChangements; // Nombre de cases modifiées depuis le dernier tour
+    bool debordement; // Trop de cases modifiées : une image complète est nécessaire
+} Diffusion;
+
+/**
+ *
+ * \struct EvenementTouche
+ *
+ * \brief Virage demandé par le joueur et instant où sa touche a été lue
+ *
+ */
+typedef struct
+{
+    char direction; // Direction demandée
+    struct timespec arrivee; // Instant de lecture de la touche (horloge monotone)
+} EvenementTouche;
+
+/**
+ *
+ * \struct FileTouches
+ *
+ * \brief File bornée des virages en attente
+ *
+ * \details Toutes les touches présentes dans le terminal sont lues à chaque tour : une suite rapide
+ * de touches (haut puis gauche dans le même tour) est jouée dans l'ordre, un virage par tour,
+ * au lieu d'être perdue ou retardée d'un tour par touche.
+ *
+ */
+typedef struct
+{
+    EvenementTouche evenements[FILE_TOUCHES_MAX]; // Virages en attente (tableau circulaire)
+    int debut; // Indice du prochain virage
+    int nombre; // Nombre de virages en attente
+    bool arret; // La touche d'arrêt a été lue
+    long virages; // Nombre de virages appliqués
+    double attente; // Temps total passé dans la file par les virages appliqués, en secondes
+} FileTouches;
+
+/**
+ *
+ * \struct EtatPartie
+ *
+ * \brief État courant d'une partie publié à chaque tour pour les outils de surveillance
+ *
+ */
+typedef struct
+{
+    long tours; // Nombre de tours joués
+    int xTete; // Coordonnée X de la tête
+    int yTete; // Coordonnée Y de la tête
+    int taille; // Taille du serpent
+    int score; // Nombre de pommes mangées
+    int tempsAttente; // Temps d'attente entre deux tours, en microsecondes
+    int xPomme; // Coordonnée X de la pomme
+    int yPomme; // Coordonnée Y de la pomme
+    long debut; // Début de la partie (horloge monotone), en nanosecondes
+    long phases[NOMBRE_PHASES]; // Temps cumulé de chaque phase des tours, en nanosecondes
+} EtatPartie;
+
+/**
+ *
+ * \struct SegmentEtat
+ *
+ * \brief Segment de mémoire partagée d'une partie, protégé par un verrou séquentiel
+ *
+ * \details Le jeu rend le compteur de séquence impair, écrit l'état, puis le rend pair : il n'attend
+ * jamais les lecteurs. Un lecteur copie l'état et recommence si le compteur était impair ou a changé
+ * pendant la copie : il ne voit jamais un état à moitié écrit. Aucun appel système n'est fait à chaque tour.
+ *
+ */
+typedef struct
+{
+    uint32_t magie; // MAGIE_ETAT_PARTAGE
+    int32_t pid; // PID du jeu
+    _Atomic uint32_t sequence; // Compteur de séquence, impair pendant une écriture
+    EtatPartie etat; // Dernier état publié
+} SegmentEtat;
+
+
 // Prototypes des fonctions
-int kbhit(); // Fonction qui permet de détecter si un caractère est présent dans le terminal
+void lireTouches(FileTouches *file, char direction); // Lit toutes les touches présentes dans le terminal et met les virages en attente
+char prochaineDirection(FileTouches *file, char direction); // Retire le prochain virage de la file
 void gotoXY(int x, int y); // Permet de se déplacer dans le terminal
 void disableEcho(); // Désactive l'affichage des touches clavier dans le terminal
 void enableEcho(); // Active l'affichage des touches clavier dans le terminal
 void afficher(int x, int y, char c); // Permet d'afficher un caractère dans le terminal
 void effacer(int x, int y); // Permet d'effacer un caractère dans le terminal
 void dessinerSerpent(int lesX[], int lesY[], int taille); // Dessine le serpent dans le terminal
-bool progresser(int lesX[], int lesY[], char direction, bool *collision, int coordPlateau[LARGEUR_TABLEAU_PLATEAU][HAUTEUR_TABLEAU_PLATEAU], int *taille); // Permet de faire progresser le serpent dans le terminal et dans la direction souhaitée
-void initPlateau(int coordPlateau[LARGEUR_TABLEAU_PLATEAU][HAUTEUR_TABLEAU_PLATEAU]); // Permet de créer un plateau de jeu aux dimensions souhaitées avec le nombre de pavés (obstacles) souhaités
-void dessinerPlateau(int coordPlateau[LARGEUR_TABLEAU_PLATEAU][HAUTEUR_TABLEAU_PLATEAU]); // Permet de déssiner le plateau du jeu
-void ajouterPomme(int coordPlateau[LARGEUR_TABLEAU_PLATEAU][HAUTEUR_TABLEAU_PLATEAU], int lesX[], int lesY[], int taille); // Permet de faire apparaître une pomme à une position aléatoire sur le plateau de jeu et de l'ajouter au tableau des coordonnées du plateau
-
+void avancerTete(int *x, int *y, char direction); // Déplace des coordonnées d'une case dans la direction souhaitée
+char directionOpposee(char direction); // Renvoie la direction opposée
+void initNiveau(Niveau *niveau); // Prépare un niveau sans portail
+bool ajouterPortail(Niveau *niveau, int x1, int y1, char direction1, int x2, int y2, char direction2); // Relie deux cases du niveau par un portail
+void initNiveauStandard(Niveau *niveau); // Prépare le niveau du jeu : issues gauche/droite et haut/bas reliées
+bool caseObstacle(const Partie *partie, int x, int y); // Indique si une case est une bordure ou un pavé
+int trouverRacine(int parents[], int cellule); // Trouve le représentant de l'ensemble d'une case (union-find)
+void calculerZones(Partie *partie); // Découpe les cases sans obstacle du plateau en zones connexes
+int zonesVoisines(const Partie *partie, int x, int y, short zones[NOMBRE_DIRECTIONS]); // Zones distinctes des cases voisines d'une case
+bool zoneParmi(short zone, const short zones[], int nombreZones); // Indique si une zone fait partie d'une liste
+short nouvelleZone(const Partie *partie); // Donne un numéro de zone inutilisé
+unsigned int groupesAutour(const Partie *partie, int x, int y); // Groupes de voisines libres reliées par les cases autour d'une case
+void renumeroterZone(Partie *partie, int x, int y, short nouvelle); // Donne un autre numéro à toute la zone d'une case
+void separerZone(Partie *partie, int x, int y, short zone); // Numérote les morceaux d'une zone coupée par une case occupée
+bool contourRelie(const Partie *partie, int x, int y, const int departs[], int nombreDeparts); // Vérifie en longeant les obstacles que les voisines d'une case se rejoignent
+void numeroterMorceaux(Partie *partie, short zone, const int departs[], int nombreDeparts); // Numérote les morceaux séparés d'une zone
+void occuperCase(Partie *partie, int x, int y); // Ajoute un segment du serpent sur une case
+void libererCase(Partie *partie, int x, int y); // Retire un segment du serpent d'une case
+int casesLibresAccessibles(const Partie *partie); // Nombre de cases libres accessibles depuis la tête
+bool progresser(Partie *partie, char direction); // Permet de faire progresser le serpent dans le terminal et dans la direction souhaitée
+void initPlateau(Partie *partie); // Permet de créer un plateau de jeu aux dimensions souhaitées avec le nombre de pavés (obstacles) souhaités
+void dessinerPlateau(char coordPlateau[LARGEUR_TABLEAU_PLATEAU][HAUTEUR_TABLEAU_PLATEAU]); // Permet de déssiner le plateau du jeu
+void ajouterPomme(Partie *partie); // Permet de faire apparaître une pomme à une position aléatoire sur le plateau de jeu et de l'ajouter au tableau des coordonnées du plateau
+void initPartie(Partie *partie, const Niveau *niveau, unsigned int graine, bool affichage); // Prépare une partie complète : serpent initial, plateau et première pomme
+bool jouerTour(Partie *partie, char direction); // Joue un mouvement et applique ses conséquences (score, nouvelle pomme)
+bool partieTerminee(const Partie *partie); // Indique si la partie est terminée (collision ou victoire)
+void reinitialiserPartie(Partie *partie, const Partie *gabarit); // Remet une partie dans l'état d'un gabarit préparé avec initPartie()
+bool creerPool(PoolParties *pool, int capacite); // Réserve un nombre fixe de parties
+Partie *prendrePartie(PoolParties *pool); // Prend une partie disponible dans la réserve
+void rendrePartie(PoolParties *pool, Partie *partie); // Rend une partie à la réserve
+void detruirePool(PoolParties *pool); // Libère la réserve
+bool ouvrirDiffusion(const char *chemin); // Ouvre la socket de diffusion de la partie aux spectateurs
+void noterCase(int x, int y, char c); // Mémorise une case affichée pour les spectateurs
+int encoderImage(unsigned char trame[], long tour); // Encode l'image complète de l'écran dans une trame
+void diffuserTour(long tour); // Envoie les changements du tour aux spectateurs
+void fermerDiffusion(); // Ferme la diffusion et déconnecte les spectateurs
+long nanosecondes(); // Temps écoulé (horloge monotone), en nanosecondes
+bool ouvrirEtatPartage(); // Crée le segment de mémoire partagée de la partie
+void publierEtat(EtatPartie *etat, const Partie *partie, int tempsAttente); // Publie l'état de la partie dans le segment
+bool lireEtatPartage(const SegmentEtat *segment, EtatPartie *etat); // Copie un état cohérent depuis un segment
+void fermerEtatPartage(); // Supprime le segment de mémoire partagée de la partie
+
+
+
+// Variables globales
+
+static const unsigned char CODES_DIRECTIONS[256] = {[UP] = 1, [DOWN] = 2, [LEFT] = 3, [RIGHT] = 4}; // Code de chaque touche (SANS_DIRECTION si ce n'est pas une direction)
+static const int ANNEAU_X[8] = {0, 1, 1, 1, 0, -1, -1, -1}; // Huit cases autour d'une case, dans l'ordre : haut, haut droite, droite... (indices pairs : voisines)
+static const int ANNEAU_Y[8] = {-1, -1, 0, 1, 1, 1, 0, -1};
+Diffusion diffusion = {.serveur = -1}; // Diffusion de la partie affichée (afficher() et effacer() n'ont pas accès à la partie)
+SegmentEtat *segmentEtat = NULL; // Segment de mémoire partagée de la partie, NULL si l'état n'est pas publié
+char nomSegmentEtat[LONGUEUR_NOM_ETAT]; // Nom du segment
 
 
 // Programme principal
 
 /**
-* \fn int main()
+* \fn int main(int argc, char *argv[])
 * \brief Programme principal du jeu Snake.
 *
 * Ce programme initialise le jeu, gère la boucle principale du jeu, 
@@ -518,120 +1014,150 @@ void ajouterPomme(int coordPlateau[LARGEUR_TABLEAU_PLATEAU][HAUTEUR_TABLEAU_PLAT
 * - Détection des collisions avec les murs, le corps du serpent et les obstacles.
 * - Gestion de la croissance du serpent lorsqu'il mange une pomme.
 * - Affichage du jeu à l'écran.
+* - Diffusion de la partie aux spectateurs si un chemin de socket est donné.
+* - Publication de l'état de la partie en mémoire partagée pour snake-top.
 *
+* \param argc Nombre d'arguments.
+* \param argv Arguments : chemin optionnel de la socket de diffusion.
 * \return 0 en cas de succès, une autre valeur en cas d'erreur.
 */
-int main()
+#ifndef SNAKE_SANS_MAIN // Les outils de simulation incluent ce fichier sans son programme principal
+int main(int argc, char *argv[])
 {
     // Initialisation des variables
-    int taille = TAILLE_INITIALE_SERPENT; // Initialisation de la taille du serpent
     int tempsAttente = DELAI_MOUVEMENTS_MS; // Initialisation du temps entre chaque mouvements, autrement-dit gestion de la vitesse
-    int score = 0; // Initialisation du score
-    int xHead = X_INITIAL; // Coordonnée x initiale de la tête du serpent
-    int yHead = Y_INITIAL; // Coordonnée y initiale de la tête du serpent
-    int lesX[TAILLE_MAX_SERPENT]; // Tableau des coordonnées X du serpent
-    int lesY[TAILLE_MAX_SERPENT]; // Tableau des coordonnées Y du serpent
-    char touche; // Touche entrée par l'utilisateur
+    FileTouches file = {0}; // Virages demandés par l'utilisateur, pas encore joués
+    EtatPartie etat = {.debut = nanosecondes()}; // État publié et temps de chaque phase des tours
     char direction = DIRECTION_INITIALE; // Définir la direction de départ
-    bool collision = false; // Définir si une collision a eu lieu
-    lesX[0] = xHead; // Initialiser les coordonnées X de la tête du serpent
-    lesY[0] = yHead; // Initialiser les coordonnées Y de la tête du serpent
-    for (int i = 1; i < TAILLE_INITIALE_SERPENT; i++) // Initialiser les coordonnées X et Y du corps du serpent
+    Partie partie; // État de la partie (plateau, serpent, pomme et score)
+    static Niveau niveau; // Niveau du jeu (table des déplacements)
+    if ((argc > 1) && (ouvrirDiffusion(argv[1]) == false)) // Diffuser la partie aux spectateurs
     {
-        lesX[i] = xHead - i;
-        lesY[i] = yHead;
+        perror(argv[1]);
+        return EXIT_FAILURE;
     }
     // Gestion du terminal
     system("clear"); // Effacer le terminal
     disableEcho(); // Désactiver l'affichage des touches clavier dans le terminal
     // Initialisation du jeu
-    int coordonneesPlateau[LARGEUR_TABLEAU_PLATEAU][HAUTEUR_TABLEAU_PLATEAU]; // Initialisation du plateau de jeu
-    initPlateau(coordonneesPlateau); // Créer le plateau de jeu
-    ajouterPomme(coordonneesPlateau, lesX, lesY, taille); // Faire apparaître la première pomme
-    dessinerSerpent(lesX, lesY, taille); // Dessiner le serpent dans le terminal
+    initNiveauStandard(&niveau); // Relier les issues du plateau
+    initPartie(&partie, &niveau, time(NULL), true); // Créer le plateau de jeu, faire apparaître la première pomme et dessiner le serpent
+    ouvrirEtatPartage(); // Publier l'état de la partie (le jeu continue sans s'il n'y a pas de mémoire partagée)
     //Boucle principale du jeu
     do
     {
-        if (kbhit() == 1) // Vérifier la présence d'un caractère
+        long instants[NOMBRE_PHASES + 1]; // Début de chaque phase du tour, puis fin du tour
+        instants[PHASE_ENTREE] = nanosecondes();
+        lireTouches(&file, direction); // Lire toutes les touches tapées depuis le dernier tour
+        direction = prochaineDirection(&file, direction); // Appliquer un seul virage par tour, dans l'ordre des touches
+        instants[PHASE_PAS] = nanosecondes();
+        bool mangee = jouerTour(&partie, direction); // Faire progresser le serpent dans le terminal, compter la pomme mangée et en faire apparaître une nouvelle
+        instants[PHASE_DIFFUSION] = nanosecondes();
+        diffuserTour(partie.tours); // Envoyer les cases modifiées aux spectateurs
+        instants[PHASE_ATTENTE] = nanosecondes();
+        usleep(tempsAttente); // Patienter un certain temps, permet ainsi de définir la vitesse du serpent
+        instants[NOMBRE_PHASES] = nanosecondes();
+        for (int phase = 0; phase < NOMBRE_PHASES; phase++) // Cumuler le temps de chaque phase
         {
-            scanf("%c", &touche); // Stocker ce caractère dans la variable touche
-            if ((touche == UP) && (direction != DOWN)) // Vérifier si ce caractère correspond à la direction 'haut' et que la direction actuelle n'est pas 'bas'
-            {
-                direction = UP; // Changer la direction pour 'haut'
-            }
-            else if ((touche == DOWN) && (direction != UP)) // Vérifier si ce caractère correspond à la direction 'bas' et que la direction actuelle n'est pas 'haut'
-            {
-                direction = DOWN; // Changer la direction pour 'bas'
-            }
-            else if ((touche == LEFT) && (direction != RIGHT)) // Vérifier si ce caractère correspond à la direction 'gauche' et que la direction actuelle n'est pas 'droite'
-            {
-                direction = LEFT; // Changer la direction pour 'gauche'
-            }
-            else if ((touche == RIGHT) && (direction != LEFT)) // Vérifier si ce caractère correspond à la direction 'droite' et que la direction actuelle n'est pas 'gauche'
-            {
-                direction = RIGHT; // Changer la direction pour 'droite'
-            }
+            etat.phases[phase] += instants[phase + 1] - instants[phase];
         }
-        bool mangee = progresser(lesX, lesY, direction, &collision, coordonneesPlateau, &taille); // Faire progresser le serpent dans le terminal
-        usleep(tempsAttente); // Patienter un certain temps, permet ainsi de définir la vitesse du serpent
         if (mangee) // Si le serpent a mangé une pomme
         {
-            score++; // Le score augmente de 1
             tempsAttente = tempsAttente * DIMINUTION_DELAI_MOUVEMENTS_MS; // Diminution du délai -> Augmentation de la vitesse
-            if (score < NOMBRE_DE_POMMES) // Si le score est inférieur au nombre de pommes
-            {
-                ajouterPomme(coordonneesPlateau, lesX, lesY, taille); // Faire apparaître une nouvelle pomme
-            }
         }
-    } while ((touche != STOP) && (collision == false) && (score != NOMBRE_DE_POMMES)); // Le serpent progresse dans le terminal dans les directions choisies tant qu'on ne tape pas 'a', qu'on ne touche pas de pavé/bordure et qu'on ne gagne pas
-    dessinerSerpent(lesX, lesY, taille); // Afficher le serpent dans le terminal
+        publierEtat(&etat, &partie, tempsAttente); // Publier l'état du tour pour snake-top
+    } while ((file.arret == false) && (partieTerminee(&partie) == false)); // Le serpent progresse dans le terminal dans les directions choisies tant qu'on ne tape pas 'a', qu'on ne touche pas de pavé/bordure et qu'on ne gagne pas
+    dessinerSerpent(partie.lesX, partie.lesY, partie.taille); // Afficher le serpent dans le terminal
+    diffuserTour(partie.tours);
+    fermerDiffusion();
+    fermerEtatPartage();
     gotoXY(1, (HAUTEUR_PLATEAU + 1)); // Aller sous le plateau de jeu
     printf("%s", MESSAGE_FIN); // Afficher le message de fin
+    if (file.virages > 0) // Délai moyen entre la lecture d'une touche et son virage
+    {
+        printf("Attente moyenne des virages : %.1f ms\n", 1000 * file.attente / file.virages);
+    }
     enableEcho(); // Réactiver l'affichage des touches clavier dans le terminal
     return EXIT_SUCCESS;
 }
+#endif
 
 
 // Fonctions
 
 /**
- * \fn int kbhit()
- * \brief Fonction permettant de détecter si un caractère est présent dans le terminal.
+ * \fn void lireTouches(FileTouches *file, char direction)
+ * \brief Lit toutes les touches présentes dans le terminal et met les virages valides en attente.
  * 
- * Cette fonction permet de vérifier si un caractère a été saisi dans le terminal sans bloquer l'exécution du programme.
+ * Un virage est comparé au dernier virage en attente (ou à la direction courante si la file est vide) :
+ * un demi-tour ou une répétition de la même direction est ignoré. Quand la file est pleine, les touches
+ * suivantes sont ignorées. La touche d'arrêt est notée dans la file.
  * 
- * \return Retourne 1 si un caractère est présent dans le terminal, sinon 0.
+ * \param file File des virages en attente.
+ * \param direction Direction courante du serpent.
  */
-int kbhit() // Fonction qui permet de détecter si un caractère est présent dans le terminal
+void lireTouches(FileTouches *file, char direction) // Lit toutes les touches présentes dans le terminal et met les virages en attente
 {
-	// la fonction retourne :
-	// 1 si un caractere est present
-	// 0 si pas de caractere present
-	
-	int unCaractere=0;
-	struct termios oldt, newt;
-	int ch;
-	int oldf;
+    unsigned char touches[LECTURE_TOUCHES_MAX];
+    struct termios ancien, nouveau;
+    struct timespec arrivee;
+    ssize_t lus;
+    int drapeaux;
+
+    // mettre le terminal en mode non bloquant le temps de la lecture
+    tcgetattr(STDIN_FILENO, &ancien);
+    nouveau = ancien;
+    nouveau.c_lflag &= ~(ICANON | ECHO);
+    tcsetattr(STDIN_FILENO, TCSANOW, &nouveau);
+    drapeaux = fcntl(STDIN_FILENO, F_GETFL, 0);
+    fcntl(STDIN_FILENO, F_SETFL, drapeaux | O_NONBLOCK);
+    clock_gettime(CLOCK_MONOTONIC, &arrivee); // Toutes les touches lues maintenant partagent le même instant
+
+    char derniere = (file->nombre > 0) ? file->evenements[(file->debut + file->nombre - 1) % FILE_TOUCHES_MAX].direction : direction;
+    while ((lus = read(STDIN_FILENO, touches, sizeof(touches))) > 0) // Vider le terminal
+    {
+        for (ssize_t i = 0; i < lus; i++)
+        {
+            char touche = touches[i];
+            file->arret |= (touche == STOP);
+            if ((CODES_DIRECTIONS[touches[i]] != SANS_DIRECTION) && (touche != derniere) && (touche != directionOpposee(derniere)) && (file->nombre < FILE_TOUCHES_MAX))
+            {
+                EvenementTouche *evenement = &file->evenements[(file->debut + file->nombre) % FILE_TOUCHES_MAX];
+                evenement->direction = touche;
+                evenement->arrivee = arrivee;
+                file->nombre++;
+                derniere = touche;
+            }
+        }
+    }
 
-	// mettre le terminal en mode non bloquant
-	tcgetattr(STDIN_FILENO, &oldt);
-	newt = oldt;
-	newt.c_lflag &= ~(ICANON | ECHO);
-	tcsetattr(STDIN_FILENO, TCSANOW, &newt);
-	oldf = fcntl(STDIN_FILENO, F_GETFL, 0);
-	fcntl(STDIN_FILENO, F_SETFL, oldf | O_NONBLOCK);
- 
-	ch = getchar();
+    // restaurer le mode du terminal
+    tcsetattr(STDIN_FILENO, TCSANOW, &ancien);
+    fcntl(STDIN_FILENO, F_SETFL, drapeaux);
+}
 
-	// restaurer le mode du terminal
-	tcsetattr(STDIN_FILENO, TCSANOW, &oldt);
-	fcntl(STDIN_FILENO, F_SETFL, oldf);
- 
-	if(ch != EOF){
-		ungetc(ch, stdin);
-		unCaractere=1;
-	} 
-	return unCaractere;
+/**
+ * \fn char prochaineDirection(FileTouches *file, char direction)
+ * \brief Retire le prochain virage de la file et mesure son attente.
+ * 
+ * \param file File des virages en attente.
+ * \param direction Direction courante du serpent.
+ * \return La direction du prochain virage, ou la direction courante si aucun virage n'est en attente.
+ */
+char prochaineDirection(FileTouches *file, char direction) // Retire le prochain virage de la file
+{
+    struct timespec maintenant;
+    if (file->nombre == 0)
+    {
+        return direction;
+    }
+    const EvenementTouche *evenement = &file->evenements[file->debut];
+    clock_gettime(CLOCK_MONOTONIC, &maintenant);
+    file->attente += (maintenant.tv_sec - evenement->arrivee.tv_sec) + (maintenant.tv_nsec - evenement->arrivee.tv_nsec) / 1e9;
+    file->virages++;
+    file->debut = (file->debut + 1) % FILE_TOUCHES_MAX;
+    file->nombre--;
+    return evenement->direction;
 }
 
 /**
@@ -721,6 +1247,7 @@ void afficher(int x, int y, char c) // Permet d'afficher un caractère dans le t
         gotoXY(x, y); // Aller à la position souhaitée
         printf("%c", c); // Écrire le caractère souhaité
         gotoXY(1, 1); // Revenir au début du terminal
+        noterCase(x, y, c); // Transmettre la case aux spectateurs
     }
 }
 
@@ -738,6 +1265,7 @@ void effacer(int x, int y) // Permet d'effacer un caractère dans le terminal
     gotoXY(x, y); // Aller à la position souhaitée
     printf("%c", CARACTERE_VIDE); // Écrire le caractère espace
     gotoXY(1, 1); // Revenir au début du terminal
+    noterCase(x, y, CARACTERE_VIDE); // Transmettre la case aux spectateurs
 }
 
 /**
@@ -761,122 +1289,810 @@ void dessinerSerpent(int lesX[], int lesY[], int taille) // Dessine le serpent d
 }
 
 /**
-* \fn bool progresser(int lesX[], int lesY[], char direction, bool *collision, int coordPlateau[LARGEUR_TABLEAU_PLATEAU][HAUTEUR_TABLEAU_PLATEAU], int *taille)
-* \brief Fait avancer le serpent d'une case dans la direction spécifiée.
-*
-* Cette fonction met à jour les coordonnées de la tête du serpent, décale les autres segments,
-* vérifie les collisions avec les murs, le corps du serpent et les pommes, et met à jour le plateau de jeu en conséquence.
-*
-* @param lesX Tableau des coordonnées X des segments du serpent.
-* @param lesY Tableau des coordonnées Y des segments du serpent.
-* @param direction Direction du mouvement (RIGHT, LEFT, UP, DOWN).
-* @param collision Pointeur vers un booléen indiquant s'il y a eu collision.
-* @param coordPlateau Tableau représentant le plateau de jeu.
-* @param taille Pointeur vers la taille du serpent.
-* @return true si une pomme a été mangée, false sinon.
-*
-* **Déroulement:**
-* 1. Efface l'ancienne queue du serpent.
-* 2. Décale tous les segments du serpent d'une case dans la direction opposée à la tête.
-* 3. Met à jour les coordonnées de la tête du serpent selon la direction donnée.
-* 4. Vérifie s'il y a une collision avec un mur, le corps du serpent ou un obstacle.
-* 5. Vérifie si le serpent a mangé une pomme et met à jour le tableau du plateau en conséquence.
-* 6. Met à jour la taille du serpent si une pomme a été mangée.
-*/
-bool progresser(int lesX[], int lesY[], char direction, bool *collision, int coordPlateau[LARGEUR_TABLEAU_PLATEAU][HAUTEUR_TABLEAU_PLATEAU], int *taille) // Permet de faire progresser le serpent dans le terminal et dans la direction souhaitée
+ * \fn void avancerTete(int *x, int *y, char direction)
+ * \brief Déplace des coordonnées d'une case dans la direction souhaitée.
+ * 
+ * Sert à construire la table des liens du niveau (initNiveau()) : le serpent lui-même se déplace en lisant
+ * cette table, qui contient aussi le passage par les issues et les portails (voir ajouterPortail()).
+ * 
+ * \param x Pointeur vers la coordonnée X à déplacer.
+ * \param y Pointeur vers la coordonnée Y à déplacer.
+ * \param direction Direction du mouvement (RIGHT, LEFT, UP, DOWN).
+ */
+void avancerTete(int *x, int *y, char direction) // Déplace des coordonnées d'une case dans la direction souhaitée
 {
-    bool mangee = false; // Initialisation du bouléen à false
-    effacer(lesX[*taille - 1], lesY[*taille - 1]); // Effacer la queue
-    for (int i = (TAILLE_MAX_SERPENT - 1); i > 0; i--) // Faire évoluer chaque coordonnées du corps du serpent
-    {
-        lesX[i] = lesX[i - 1];
-        lesY[i] = lesY[i - 1];
-    }
     if (direction == RIGHT) // Vérifier si la nouvelle direction est 'droite'
     {
-        lesX[0]++; // Faire évoluer la tête d'un rang vers la droite
+        (*x)++; // Faire évoluer la tête d'un rang vers la droite
     }
     else if (direction == LEFT) // Vérifier si la nouvelle direction est 'gauche'
     {
-        lesX[0]--; // Faire évoluer la tête d'un rang vers la gauche
+        (*x)--; // Faire évoluer la tête d'un rang vers la gauche
     }
     else if (direction == UP)// Vérifier si la nouvelle direction est 'haut'
     {
-        lesY[0]--; // Faire évoluer la tête d'un rang vers le haut
+        (*y)--; // Faire évoluer la tête d'un rang vers le haut
     }
     else if (direction == DOWN) // Vérifier si la nouvelle direction est 'bas'
     {
-        lesY[0]++; // Faire évoluer la tête d'un rang vers le bas
+        (*y)++; // Faire évoluer la tête d'un rang vers le bas
     }
-    for (int i = 1; i < *taille; i++) // Vérifier les collisions entre la tête et le corps du serpent
+}
+
+/**
+ * \fn char directionOpposee(char direction)
+ * \brief Renvoie la direction opposée à une direction.
+ *
+ * \param direction Direction (RIGHT, LEFT, UP, DOWN).
+ * \return La direction opposée.
+ */
+char directionOpposee(char direction) // Renvoie la direction opposée
+{
+    char opposee = direction;
+    if (direction == UP)
     {
-        if ((lesX[i] == lesX[0]) && (lesY[i] == lesY[0]))
-        {
-            *collision = true; // Modification de la variable collision
-        }
+        opposee = DOWN;
     }
-    if ((coordPlateau[(lesX[0])][(lesY[0])] == CARACTERE_PLATEAU) || (coordPlateau[(lesX[0])][(lesY[0])] == CARACTERE_PAVE)) // Vérifier les collision entre la tête du serpent et un pavé ou une bordure du plateau
+    else if (direction == DOWN)
     {
-        *collision = true; // Modification de la variable collision
+        opposee = UP;
     }
-    if ((lesX[0] > X_ISSUE_DROITE) && (lesY[0] == Y_ISSUES_GAUCHE_DROITE)) // Vérifier si la tête du serpent atteint l'issue droite
+    else if (direction == LEFT)
     {
-        lesX[0] = X_ISSUE_GAUCHE; // Faire rerentrer le serpent sur le plateau en le faisant réapparaître à l'issue gauche
+        opposee = RIGHT;
     }
-    else if ((lesX[0] < X_ISSUE_GAUCHE) && (lesY[0] == Y_ISSUES_GAUCHE_DROITE)) // Vérifier si la tête du serpent atteint l'issue gauche
+    else if (direction == RIGHT)
     {
-        lesX[0] = X_ISSUE_DROITE; // Faire rerentrer le serpent sur le plateau en le faisant réapparaître à l'issue droite
+        opposee = LEFT;
     }
-    else if ((lesX[0] == X_ISSUES_HAUT_BAS) && (lesY[0] < Y_ISSUE_HAUT)) // Vérifier si la tête du serpent atteint l'issue d'en haut
-    {
-        lesY[0] = Y_ISSUE_BAS; // Faire rerentrer le serpent sur le plateau en le faisant réapparaître à l'issue d'en bas
+    return opposee;
+}
+
+/**
+ * \fn void initNiveau(Niveau *niveau)
+ * \brief Prépare un niveau sans portail : chaque mouvement mène à la case voisine.
+ * 
+ * Un mouvement qui sortirait du tableau du plateau (depuis une bordure, donc après une collision) laisse la tête
+ * sur sa case ; le code SANS_DIRECTION laisse toujours la tête sur sa case.
+ * 
+ * \param niveau Niveau à préparer.
+ */
+void initNiveau(Niveau *niveau) // Prépare un niveau sans portail
+{
+    const char directions[NOMBRE_DIRECTIONS + 1] = {SANS_DIRECTION, UP, DOWN, LEFT, RIGHT}; // Direction de chaque code
+    niveau->nombrePortails = 0;
+    for (int x = 0; x < LARGEUR_TABLEAU_PLATEAU; x++)
+    {
+        for (int y = 0; y < HAUTEUR_TABLEAU_PLATEAU; y++)
+        {
+            niveau->geometrique[x][y] = (x > 0) && (x < LARGEUR_TABLEAU_PLATEAU - 1) && (y > 0) && (y < HAUTEUR_TABLEAU_PLATEAU - 1); // Huit cases autour dans le tableau
+            for (int code = 0; code <= NOMBRE_DIRECTIONS; code++)
+            {
+                int xVoisin = x;
+                int yVoisin = y;
+                avancerTete(&xVoisin, &yVoisin, directions[code]);
+                if ((xVoisin < 0) || (xVoisin >= LARGEUR_TABLEAU_PLATEAU) || (yVoisin < 0) || (yVoisin >= HAUTEUR_TABLEAU_PLATEAU)) // Sortie du tableau
+                {
+                    xVoisin = x;
+                    yVoisin = y;
+                }
+                niveau->liens[x][y][code] = (Lien){xVoisin, yVoisin, false};
+            }
+        }
     }
-    else if ((lesX[0] == X_ISSUES_HAUT_BAS) && (lesY[0] > Y_ISSUE_BAS)) // Vérifier si la tête du serpent atteint l'issue d'en bas
+    for (unsigned int colonnes = 0; colonnes < 512; colonnes++) // Groupes de voisines reliées par l'anneau autour d'une case
     {
-        lesY[0] = Y_ISSUE_HAUT; // Faire rerentrer le serpent sur le plateau en le faisant réapparaître à l'issue haut
+        unsigned int libres = 0; // Cases libres de l'anneau (bit k : case k de ANNEAU_X/ANNEAU_Y)
+        for (int k = 0; k < 8; k++) // Trois bits par colonne, de haut en bas ; la case du milieu est ignorée
+        {
+            libres |= ((colonnes >> (3 * (ANNEAU_X[k] + 1) + ANNEAU_Y[k] + 1)) & 1) << k;
+        }
+        niveau->groupesAnneau[colonnes] = (libres == 255) ? 1 : 0; // Anneau entièrement libre : un seul groupe
+        for (int k = 0; (k < 8) && (libres != 255); k += 2) // Une voisine libre commence un groupe si la voisine précédente n'y est pas reliée
+        {
+            bool libre = libres & (1 << k);
+            bool precedenteReliee = (libres & (1 << ((k + 7) % 8))) && (libres & (1 << ((k + 6) % 8)));
+            niveau->groupesAnneau[colonnes] |= (libre && (precedenteReliee == false)) << k;
+        }
     }
-    if (coordPlateau[lesX[0]][lesY[0]] == POMME) // Vérifier si la tête du serpent atteint une pomme
+}
+
+/**
+ * \fn bool ajouterPortail(Niveau *niveau, int x1, int y1, char direction1, int x2, int y2, char direction2)
+ * \brief Relie deux cases du niveau par un portail.
+ * 
+ * Quitter la première case dans la première direction mène à la seconde case, et quitter la seconde case
+ * dans la seconde direction mène à la première. Les deux cases sont ouvertes dans les bordures par initPlateau().
+ * Comme pour les issues du jeu, aucune collision n'est possible pendant le passage : les collisions
+ * sont vérifiées avant le passage du portail, sur une case hors du plateau.
+ * 
+ * \param niveau Niveau à modifier.
+ * \param x1 Coordonnée X de la première case.
+ * \param y1 Coordonnée Y de la première case.
+ * \param direction1 Direction par laquelle on quitte la première case.
+ * \param x2 Coordonnée X de la seconde case.
+ * \param y2 Coordonnée Y de la seconde case.
+ * \param direction2 Direction par laquelle on quitte la seconde case.
+ * \return true si le portail a été ajouté, false si le niveau en a déjà PORTAILS_MAX ou si le portail est invalide.
+ */
+bool ajouterPortail(Niveau *niveau, int x1, int y1, char direction1, int x2, int y2, char direction2) // Relie deux cases du niveau par un portail
+{
+    if ((niveau->nombrePortails == PORTAILS_MAX) || (CODES_DIRECTIONS[(unsigned char)direction1] == SANS_DIRECTION) || (CODES_DIRECTIONS[(unsigned char)direction2] == SANS_DIRECTION)
+        || (x1 < DECALAGE) || (x1 >= LARGEUR_TABLEAU_PLATEAU) || (y1 < DECALAGE) || (y1 >= HAUTEUR_TABLEAU_PLATEAU)
+        || (x2 < DECALAGE) || (x2 >= LARGEUR_TABLEAU_PLATEAU) || (y2 < DECALAGE) || (y2 >= HAUTEUR_TABLEAU_PLATEAU))
     {
-        mangee = true; // Modification du booléen
-        coordPlateau[(lesX[0])][(lesY[0])] = CARACTERE_VIDE; // Remplacer la pomme du tableau par un espace vide
-        (*taille)++; // Augmentation de la taille du serpent
+        return false;
+    }
+    niveau->portails[niveau->nombrePortails] = (Portail){x1, y1, direction1, x2, y2, direction2};
+    niveau->nombrePortails++;
+    niveau->liens[x1][y1][CODES_DIRECTIONS[(unsigned char)direction1]] = (Lien){x2, y2, true};
+    niveau->liens[x2][y2][CODES_DIRECTIONS[(unsigned char)direction2]] = (Lien){x1, y1, true};
+    niveau->geometrique[x1][y1] = false; // Un déplacement depuis ces cases peut passer le portail
+    niveau->geometrique[x2][y2] = false;
+    return true;
+}
+
+/**
+ * \fn void initNiveauStandard(Niveau *niveau)
+ * \brief Prépare le niveau du jeu : l'issue droite est reliée à l'issue gauche, l'issue basse à l'issue haute.
+ * 
+ * \param niveau Niveau à préparer.
+ */
+void initNiveauStandard(Niveau *niveau) // Prépare le niveau du jeu : issues gauche/droite et haut/bas reliées
+{
+    initNiveau(niveau);
+    ajouterPortail(niveau, X_ISSUE_DROITE, Y_ISSUES_GAUCHE_DROITE, RIGHT, X_ISSUE_GAUCHE, Y_ISSUES_GAUCHE_DROITE, LEFT);
+    ajouterPortail(niveau, X_ISSUES_HAUT_BAS, Y_ISSUE_BAS, DOWN, X_ISSUES_HAUT_BAS, Y_ISSUE_HAUT, UP);
+}
+
+/**
+ * \fn bool caseObstacle(const Partie *partie, int x, int y)
+ * \brief Indique si une case est une bordure ou un pavé.
+ * 
+ * Les coordonnées situées en dehors du tableau du plateau (tête en train de passer par une issue)
+ * ne sont jamais considérées comme un obstacle.
+ * 
+ * \param partie Partie contenant le plateau.
+ * \param x Coordonnée X de la case.
+ * \param y Coordonnée Y de la case.
+ * \return true si la case est une bordure ou un pavé, false sinon.
+ */
+bool caseObstacle(const Partie *partie, int x, int y) // Indique si une case est une bordure ou un pavé
+{
+    if ((x < 0) || (x >= LARGEUR_TABLEAU_PLATEAU) || (y < 0) || (y >= HAUTEUR_TABLEAU_PLATEAU)) // Vérifier que la case appartient au tableau du plateau
+    {
+        return false;
+    }
+    return (partie->coordPlateau[x][y] == CARACTERE_PLATEAU) || (partie->coordPlateau[x][y] == CARACTERE_PAVE);
+}
+
+/**
+* \fn bool progresser(Partie *partie, char direction)
+* \brief Fait avancer le serpent d'une case dans la direction spécifiée.
+*
+* Cette fonction met à jour les coordonnées de la tête du serpent, décale les autres segments,
+* vérifie les collisions avec les murs, le corps du serpent et les pommes, et met à jour le plateau de jeu en conséquence.
+* Le serpent n'est redessiné que si l'affichage de la partie est activé.
+*
+* @param partie Partie en cours (plateau, serpent, collision).
+* @param direction Direction du mouvement (RIGHT, LEFT, UP, DOWN).
+* @return true si une pomme a été mangée, false sinon.
+*
+* **Déroulement:**
+* 1. Efface l'ancienne queue du serpent.
+* 2. Décale tous les segments du serpent d'une case dans la direction opposée à la tête.
+* 3. Lit la case atteinte par la tête dans la table des liens du niveau (portails compris), sans aucun test.
+* 4. Si la case atteinte n'a pas de pomme, la queue quitte sa case (la tête peut donc la suivre de près).
+* 5. Vérifie s'il y a une collision avec le corps du serpent, une bordure ou un pavé, sauf lors du passage d'un portail :
+*    le corps est lu dans l'occupation des cases, une seule lecture quelle que soit la taille du serpent.
+* 6. Si la tête atteint une pomme, la retire du tableau du plateau et fait grandir le serpent.
+* 7. La tête occupe sa nouvelle case.
+*/
+bool progresser(Partie *partie, char direction) // Permet de faire progresser le serpent dans le terminal et dans la direction souhaitée
+{
+    int *lesX = partie->lesX; // Coordonnées X du serpent
+    int *lesY = partie->lesY; // Coordonnées Y du serpent
+    int xQueue = lesX[partie->taille - 1]; // Coordonnée X de la queue avant le mouvement
+    int yQueue = lesY[partie->taille - 1]; // Coordonnée Y de la queue avant le mouvement
+    if (partie->affichage) // Vérifier si la partie est affichée
+    {
+        effacer(xQueue, yQueue); // Effacer la queue
+    }
+    for (int i = (TAILLE_MAX_SERPENT - 1); i > 0; i--) // Faire évoluer chaque coordonnées du corps du serpent
+    {
+        lesX[i] = lesX[i - 1];
+        lesY[i] = lesY[i - 1];
+    }
+    Lien lien = partie->niveau->liens[lesX[0]][lesY[0]][CODES_DIRECTIONS[(unsigned char)direction]]; // Case atteinte par la tête, issues et portails compris
+    lesX[0] = lien.x; // Faire évoluer la tête d'un rang dans la direction souhaitée
+    lesY[0] = lien.y;
+    partie->direction = direction; // Mémoriser la direction du mouvement
+    char contenu = partie->coordPlateau[lien.x][lien.y]; // Contenu de la case atteinte
+    bool mangee = (contenu == POMME); // La pomme est mangée sur la case atteinte, après le passage d'un portail
+    if (mangee == false) // La queue n'a pas grandi : elle libère sa case avant le test du corps
+    {
+        libererCase(partie, xQueue, yQueue);
+    }
+    bool contact = (contenu == CARACTERE_PLATEAU) | (contenu == CARACTERE_PAVE) | (partie->occupation[lien.x][lien.y] > 0); // Bordure, pavé ou corps du serpent
+    partie->collision |= contact & !lien.portail; // Les collisions sont vérifiées avant le passage d'un portail, hors du plateau : il n'y en a jamais
+    if (mangee) // Vérifier si la tête du serpent atteint une pomme
+    {
+        partie->coordPlateau[lien.x][lien.y] = CARACTERE_VIDE; // Remplacer la pomme du tableau par un espace vide
+        partie->taille++; // Augmentation de la taille du serpent
+    }
+    occuperCase(partie, lien.x, lien.y); // La tête occupe sa nouvelle case
+    if (partie->affichage) // Vérifier si la partie est affichée
+    {
+        dessinerSerpent(lesX, lesY, partie->taille); // Afficher le serpent à sa nouvelle position
     }
-    dessinerSerpent(lesX, lesY, *taille); // Afficher le serpent à sa nouvelle position
     return mangee; // Transmettre au programme principal si une pomme a été mangée ou non
 }
 
 /**
-* \fn void initPlateau(int coordPlateau[LARGEUR_TABLEAU_PLATEAU][HAUTEUR_TABLEAU_PLATEAU])
+ * \fn int trouverRacine(int parents[], int cellule)
+ * \brief Trouve le représentant de l'ensemble contenant une case (structure union-find).
+ * 
+ * Les chemins parcourus sont raccourcis au passage, les recherches suivantes sont donc presque immédiates.
+ * 
+ * \param parents Parent de chaque case dans la forêt union-find.
+ * \param cellule Indice de la case (x * HAUTEUR_TABLEAU_PLATEAU + y).
+ * \return L'indice du représentant.
+ */
+int trouverRacine(int parents[], int cellule) // Trouve le représentant de l'ensemble d'une case (union-find)
+{
+    while (parents[cellule] != cellule)
+    {
+        parents[cellule] = parents[parents[cellule]]; // Raccourcir le chemin
+        cellule = parents[cellule];
+    }
+    return cellule;
+}
+
+/**
+ * \fn void calculerZones(Partie *partie)
+ * \brief Découpe les cases sans obstacle du plateau en zones connexes.
+ * 
+ * Deux cases voisines sans obstacle, y compris deux cases reliées par un portail, appartiennent à la même zone.
+ * Le calcul complet n'est fait qu'une fois par plateau, avant que le serpent soit placé, puisque les bordures et les pavés
+ * ne bougent pas. Les zones sont ensuite tenues à jour à chaque mouvement du serpent, dont le corps est lui aussi un obstacle :
+ * la case occupée par la tête peut couper sa zone (separerZone()), celle libérée par la queue peut en réunir plusieurs (libererCase()).
+ * 
+ * \param partie Partie dont le plateau vient d'être créé.
+ */
+void calculerZones(Partie *partie) // Découpe les cases sans obstacle du plateau en zones connexes
+{
+    int parents[NOMBRE_CASES_TABLEAU]; // Forêt union-find des cases
+    int zones[NOMBRE_CASES_TABLEAU]; // Zone attribuée à chaque représentant
+    int nombreZones = 0;
+    memset(partie->libresZone, 0, sizeof(partie->libresZone)); // Aucun numéro de zone utilisé
+    for (int i = 0; i < NOMBRE_CASES_TABLEAU; i++) // Chaque case forme d'abord son propre ensemble
+    {
+        parents[i] = i;
+        zones[i] = AUCUNE_ZONE;
+    }
+    for (int x = X_BORDURE_GAUCHE_PLATEAU; x <= X_BORDURE_DROITE_PLATEAU; x++) // Réunir les cases voisines sans obstacle
+    {
+        for (int y = Y_BORDURE_HAUT_PLATEAU; y <= Y_BORDURE_BAS_PLATEAU; y++)
+        {
+            for (int code = 1; (code <= NOMBRE_DIRECTIONS) && (caseObstacle(partie, x, y) == false); code++)
+            {
+                Lien lien = partie->niveau->liens[x][y][code]; // Mêmes déplacements que la tête du serpent, portails compris
+                if ((lien.x >= X_BORDURE_GAUCHE_PLATEAU) && (lien.x <= X_BORDURE_DROITE_PLATEAU) && (lien.y >= Y_BORDURE_HAUT_PLATEAU) && (lien.y <= Y_BORDURE_BAS_PLATEAU) && (caseObstacle(partie, lien.x, lien.y) == false))
+                {
+                    parents[trouverRacine(parents, x * HAUTEUR_TABLEAU_PLATEAU + y)] = trouverRacine(parents, lien.x * HAUTEUR_TABLEAU_PLATEAU + lien.y);
+                }
+            }
+        }
+    }
+    for (int x = 0; x < LARGEUR_TABLEAU_PLATEAU; x++) // Numéroter les zones et compter leurs cases
+    {
+        partie->libresColonne[x] = 0;
+        for (int y = 0; y < HAUTEUR_TABLEAU_PLATEAU; y++)
+        {
+            partie->zone[x][y] = AUCUNE_ZONE;
+            if ((x >= X_BORDURE_GAUCHE_PLATEAU) && (x <= X_BORDURE_DROITE_PLATEAU) && (y >= Y_BORDURE_HAUT_PLATEAU) && (y <= Y_BORDURE_BAS_PLATEAU) && (caseObstacle(partie, x, y) == false))
+            {
+                int racine = trouverRacine(parents, x * HAUTEUR_TABLEAU_PLATEAU + y);
+                if (zones[racine] == AUCUNE_ZONE) // Nouvelle zone
+                {
+                    zones[racine] = nombreZones;
+                    nombreZones++;
+                }
+                partie->zone[x][y] = zones[racine];
+                partie->libresZone[zones[racine]]++;
+                partie->libresColonne[x] |= (uint64_t)1 << y;
+            }
+        }
+    }
+}
+
+/**
+ * \fn int zonesVoisines(const Partie *partie, int x, int y, short zones[NOMBRE_DIRECTIONS])
+ * \brief Donne les zones distinctes des cases voisines d'une case (portails compris).
+ * 
+ * \param partie Partie en cours.
+ * \param x Coordonnée X de la case.
+ * \param y Coordonnée Y de la case.
+ * \param zones Zones trouvées.
+ * \return Le nombre de zones trouvées.
+ */
+int zonesVoisines(const Partie *partie, int x, int y, short zones[NOMBRE_DIRECTIONS]) // Zones distinctes des cases voisines d'une case
+{
+    int nombreZones = 0;
+    for (int code = 1; code <= NOMBRE_DIRECTIONS; code++)
+    {
+        Lien lien = partie->niveau->liens[x][y][code]; // Mêmes déplacements que la tête du serpent
+        short zone = partie->zone[lien.x][lien.y];
+        if ((zone != AUCUNE_ZONE) && (zoneParmi(zone, zones, nombreZones) == false))
+        {
+            zones[nombreZones++] = zone;
+        }
+    }
+    return nombreZones;
+}
+
+/**
+ * \fn bool zoneParmi(short zone, const short zones[], int nombreZones)
+ * \brief Indique si une zone fait partie d'une liste de zones.
+ * 
+ * \param zone Zone cherchée.
+ * \param zones Liste de zones.
+ * \param nombreZones Nombre de zones de la liste.
+ * \return true si la zone est dans la liste, false sinon (toujours false pour AUCUNE_ZONE).
+ */
+bool zoneParmi(short zone, const short zones[], int nombreZones) // Indique si une zone fait partie d'une liste
+{
+    bool trouvee = false;
+    for (int i = 0; i < nombreZones; i++)
+    {
+        trouvee |= (zones[i] == zone);
+    }
+    return trouvee;
+}
+
+/**
+ * \fn short nouvelleZone(const Partie *partie)
+ * \brief Donne un numéro de zone inutilisé (le plus petit, les zones en cours restent donc numérotées à partir de 0).
+ * 
+ * \param partie Partie en cours.
+ * \return Un numéro de zone sans aucune case.
+ */
+short nouvelleZone(const Partie *partie) // Donne un numéro de zone inutilisé
+{
+    short zone = 0;
+    while (partie->libresZone[zone] > 0) // Une zone utilisée a au moins une case
+    {
+        zone++;
+    }
+    return zone;
+}
+
+/**
+ * \fn void renumeroterZone(Partie *partie, int x, int y, short nouvelle)
+ * \brief Donne un autre numéro à toute la zone d'une case libre (parcours en largeur).
+ * 
+ * \param partie Partie en cours.
+ * \param x Coordonnée X d'une case de la zone.
+ * \param y Coordonnée Y d'une case de la zone.
+ * \param nouvelle Nouveau numéro de la zone.
+ */
+void renumeroterZone(Partie *partie, int x, int y, short nouvelle) // Donne un autre numéro à toute la zone d'une case
+{
+    short file[NOMBRE_CASES_TABLEAU]; // File du parcours (x * HAUTEUR_TABLEAU_PLATEAU + y)
+    short ancienne = partie->zone[x][y];
+    int debut = 0;
+    int fin = 0;
+    partie->zone[x][y] = nouvelle;
+    file[fin++] = x * HAUTEUR_TABLEAU_PLATEAU + y;
+    while (debut < fin)
+    {
+        int cellule = file[debut++];
+        for (int code = 1; code <= NOMBRE_DIRECTIONS; code++)
+        {
+            Lien lien = partie->niveau->liens[cellule / HAUTEUR_TABLEAU_PLATEAU][cellule % HAUTEUR_TABLEAU_PLATEAU][code];
+            if (partie->zone[lien.x][lien.y] == ancienne)
+            {
+                partie->zone[lien.x][lien.y] = nouvelle;
+                file[fin++] = lien.x * HAUTEUR_TABLEAU_PLATEAU + lien.y;
+            }
+        }
+    }
+    partie->libresZone[ancienne] -= fin;
+    partie->libresZone[nouvelle] += fin;
+}
+
+/**
+ * \fn unsigned int groupesAutour(const Partie *partie, int x, int y)
+ * \brief Donne les groupes de voisines libres d'une case reliées entre elles par les huit cases qui l'entourent.
+ * 
+ * Les trois colonnes autour de la case sont lues dans les cases libres de chaque colonne (trois lectures) ;
+ * la case elle-même est ignorée. La case ne doit pas être au bord du tableau.
+ * 
+ * \param partie Partie en cours.
+ * \param x Coordonnée X de la case.
+ * \param y Coordonnée Y de la case.
+ * \return La première voisine de chaque groupe (bit k : case k de ANNEAU_X/ANNEAU_Y) : au plus un bit si les voisines libres se rejoignent autour de la case.
+ */
+unsigned int groupesAutour(const Partie *partie, int x, int y) // Groupes de voisines libres reliées par les cases autour d'une case
+{
+    unsigned int colonnes = ((partie->libresColonne[x - 1] >> (y - 1)) & 7) | (((partie->libresColonne[x] >> (y - 1)) & 7) << 3) | (((partie->libresColonne[x + 1] >> (y - 1)) & 7) << 6);
+    return partie->niveau->groupesAnneau[colonnes];
+}
+
+/**
+ * \fn void separerZone(Partie *partie, int x, int y, short zone)
+ * \brief Vérifie si une case qui vient d'être occupée coupe sa zone en plusieurs morceaux, et numérote les morceaux séparés.
+ * 
+ * Le plus souvent, la vérification reste locale : si les cases libres voisines se rejoignent par les huit cases
+ * qui entourent la case occupée (groupesAutour()), la zone n'est pas coupée ; sinon, le plus souvent, longer l'obstacle
+ * (contourRelie()) suffit à rejoindre les voisines. En dernier recours (zone réellement coupée, voisines reliées par un portail),
+ * numeroterMorceaux() parcourt la zone depuis chaque groupe de voisines à la fois.
+ * 
+ * \param partie Partie en cours.
+ * \param x Coordonnée X de la case occupée.
+ * \param y Coordonnée Y de la case occupée.
+ * \param zone Zone de la case avant qu'elle soit occupée.
+ */
+void separerZone(Partie *partie, int x, int y, short zone) // Numérote les morceaux d'une zone coupée par une case occupée
+{
+    const Niveau *niveau = partie->niveau;
+    int departs[NOMBRE_DIRECTIONS]; // Une case de départ par groupe de voisines libres
+    int nombreDeparts = 0;
+    if (niveau->geometrique[x][y]) // Voisines géométriques : vérification locale par l'anneau des huit cases autour de la case
+    {
+        unsigned int groupes = groupesAutour(partie, x, y);
+        if ((groupes & (groupes - 1)) == 0) // Au plus un groupe : les voisines se rejoignent autour de la case
+        {
+            return;
+        }
+        bool plan = true; // Toutes les voisines de départ peuvent être longées sans sortir du tableau ni passer un portail
+        for (int k = 0; k < 8; k += 2)
+        {
+            if (groupes & (1u << k))
+            {
+                departs[nombreDeparts++] = (x + ANNEAU_X[k]) * HAUTEUR_TABLEAU_PLATEAU + y + ANNEAU_Y[k];
+                plan &= niveau->geometrique[x + ANNEAU_X[k]][y + ANNEAU_Y[k]];
+            }
+        }
+        if (plan && contourRelie(partie, x, y, departs, nombreDeparts)) // Les voisines se rejoignent en longeant l'obstacle
+        {
+            return;
+        }
+    }
+    else
+    {
+        for (int code = 1; code <= NOMBRE_DIRECTIONS; code++) // Voisines libres de la zone, portails compris
+        {
+            Lien lien = niveau->liens[x][y][code];
+            int cellule = lien.x * HAUTEUR_TABLEAU_PLATEAU + lien.y;
+            bool nouvelle = (partie->zone[lien.x][lien.y] == zone);
+            for (int i = 0; i < nombreDeparts; i++) // Une même voisine peut être atteinte par deux directions
+            {
+                nouvelle &= (departs[i] != cellule);
+            }
+            if (nouvelle)
+            {
+                departs[nombreDeparts++] = cellule;
+            }
+        }
+        if (nombreDeparts <= 1) // Au plus une voisine libre : la zone ne peut pas être coupée
+        {
+            return;
+        }
+    }
+    numeroterMorceaux(partie, zone, departs, nombreDeparts);
+}
+
+/**
+ * \fn bool contourRelie(const Partie *partie, int x, int y, const int departs[], int nombreDeparts)
+ * \brief Suit le bord des obstacles autour d'une case qui vient d'être occupée, pour vérifier que ses voisines libres se rejoignent.
+ * 
+ * Sur un plateau plan, deux voisines libres d'une case occupée sont dans le même morceau de zone si et
+ * seulement si le bord de l'obstacle qui contient la case (cases bloquées voisines, diagonales comprises) les relie.
+ * Deux marcheurs longent ce bord depuis la première voisine, l'un la main droite contre l'obstacle, l'autre la main
+ * gauche : le coût est celui du plus court détour autour de l'obstacle, et non la surface de la zone.
+ * Les marcheurs ne passent que par des cases géométriques (Niveau::geometrique) : les cases d'un portail comptent
+ * comme des obstacles, et des voisines reliées seulement par un portail ne sont pas trouvées.
+ * 
+ * \param partie Partie en cours.
+ * \param x Coordonnée X de la case occupée.
+ * \param y Coordonnée Y de la case occupée.
+ * \param departs Voisines libres et géométriques de la case (x * HAUTEUR_TABLEAU_PLATEAU + y), au plus NOMBRE_DIRECTIONS.
+ * \param nombreDeparts Nombre de voisines.
+ * \return true si toutes les voisines sont reliées, false si la zone est peut-être coupée.
+ */
+bool contourRelie(const Partie *partie, int x, int y, const int departs[], int nombreDeparts) // Vérifie en longeant les obstacles que les voisines d'une case se rejoignent
+{
+    const int pasX[NOMBRE_DIRECTIONS] = {0, 1, 0, -1}; // Haut, droite, bas, gauche : tourner à droite ajoute 1
+    const int pasY[NOMBRE_DIRECTIONS] = {-1, 0, 1, 0};
+    const Niveau *niveau = partie->niveau;
+    int xDepart = departs[0] / HAUTEUR_TABLEAU_PLATEAU;
+    int yDepart = departs[0] % HAUTEUR_TABLEAU_PLATEAU;
+    int versCase = 0; // Direction de la première voisine vers la case occupée
+    while ((xDepart + pasX[versCase] != x) || (yDepart + pasY[versCase] != y))
+    {
+        versCase++;
+    }
+    int marcheurX[2] = {xDepart, xDepart}; // Marcheur 0 : main droite contre l'obstacle ; marcheur 1 : main gauche
+    int marcheurY[2] = {yDepart, yDepart};
+    int cap[2] = {(versCase + 3) % NOMBRE_DIRECTIONS, (versCase + 1) % NOMBRE_DIRECTIONS}; // La case occupée sous la main
+    int reliees = 1; // Voisines atteintes par les marcheurs (la première comprise)
+    bool atteinte[NOMBRE_DIRECTIONS] = {true, false, false, false};
+    for (int pas = 0; pas < 4 * NOMBRE_CASES_TABLEAU; pas++) // Un contour passe au plus quatre fois par chaque case
+    {
+        int m = pas % 2;
+        int cote = (m == 0) ? (cap[m] + 1) % NOMBRE_DIRECTIONS : (cap[m] + 3) % NOMBRE_DIRECTIONS; // Côté de l'obstacle
+        int xCote = marcheurX[m] + pasX[cote];
+        int yCote = marcheurY[m] + pasY[cote];
+        int xDevant = marcheurX[m] + pasX[cap[m]];
+        int yDevant = marcheurY[m] + pasY[cap[m]];
+        if ((partie->zone[xCote][yCote] != AUCUNE_ZONE) && niveau->geometrique[xCote][yCote]) // L'obstacle s'arrête : le contourner
+        {
+            cap[m] = cote;
+        }
+        else if ((partie->zone[xDevant][yDevant] == AUCUNE_ZONE) || (niveau->geometrique[xDevant][yDevant] == false)) // Obstacle devant : tourner sans avancer
+        {
+            cap[m] = (m == 0) ? (cap[m] + 3) % NOMBRE_DIRECTIONS : (cap[m] + 1) % NOMBRE_DIRECTIONS;
+            continue;
+        }
+        marcheurX[m] += pasX[cap[m]];
+        marcheurY[m] += pasY[cap[m]];
+        if ((marcheurX[m] == xDepart) && (marcheurY[m] == yDepart) && (cap[m] == ((m == 0) ? (versCase + 3) % NOMBRE_DIRECTIONS : (versCase + 1) % NOMBRE_DIRECTIONS)))
+        {
+            return false; // Tour complet du contour sans rejoindre toutes les voisines
+        }
+        for (int i = 1; i < nombreDeparts; i++)
+        {
+            if ((atteinte[i] == false) && (marcheurX[m] * HAUTEUR_TABLEAU_PLATEAU + marcheurY[m] == departs[i]))
+            {
+                atteinte[i] = true;
+                reliees++;
+            }
+        }
+        if (reliees == nombreDeparts)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * \fn void numeroterMorceaux(Partie *partie, short zone, const int departs[], int nombreDeparts)
+ * \brief Parcourt une zone depuis plusieurs cases à la fois, et donne un nouveau numéro à chaque morceau séparé des autres.
+ * 
+ * Les parcours en largeur avancent d'une case à tour de rôle : deux parcours qui se rencontrent sont dans le même morceau,
+ * et un morceau dont tous les parcours sont épuisés est séparé. Le dernier morceau en course garde le numéro de la zone :
+ * le coût est celui des plus petits morceaux, pas celui de la zone entière. Les cases atteintes par chaque parcours
+ * forment une liste chaînée dans un seul tableau, partagé par tous les parcours.
+ * 
+ * \param partie Partie en cours.
+ * \param zone Zone parcourue.
+ * \param departs Cases de départ (x * HAUTEUR_TABLEAU_PLATEAU + y), au plus NOMBRE_DIRECTIONS.
+ * \param nombreDeparts Nombre de cases de départ.
+ */
+void numeroterMorceaux(Partie *partie, short zone, const int departs[], int nombreDeparts) // Numérote les morceaux séparés d'une zone
+{
+    unsigned char groupe[LARGEUR_TABLEAU_PLATEAU][HAUTEUR_TABLEAU_PLATEAU]; // Parcours qui a atteint chaque case (NOMBRE_DIRECTIONS : aucun)
+    short suivante[NOMBRE_CASES_TABLEAU]; // Case atteinte après chaque case par le même parcours (-1 : dernière case atteinte)
+    int premiere[NOMBRE_DIRECTIONS], derniere[NOMBRE_DIRECTIONS], prochaine[NOMBRE_DIRECTIONS]; // Liste de chaque parcours, et prochaine case à explorer (-1 : parcours épuisé)
+    int atteintes[NOMBRE_DIRECTIONS], parents[NOMBRE_DIRECTIONS];
+    bool termine[NOMBRE_DIRECTIONS];
+    int restants = nombreDeparts; // Morceaux encore en course
+    memset(groupe, NOMBRE_DIRECTIONS, sizeof(groupe));
+    for (int g = 0; g < nombreDeparts; g++)
+    {
+        groupe[departs[g] / HAUTEUR_TABLEAU_PLATEAU][departs[g] % HAUTEUR_TABLEAU_PLATEAU] = g;
+        suivante[departs[g]] = -1;
+        premiere[g] = departs[g];
+        derniere[g] = departs[g];
+        prochaine[g] = departs[g];
+        atteintes[g] = 1;
+        parents[g] = g;
+        termine[g] = false;
+    }
+    while (restants > 1)
+    {
+        bool epuisement = false; // Un parcours s'est épuisé pendant ce tour
+        for (int g = 0; g < nombreDeparts; g++) // Un pas de chaque parcours
+        {
+            if (prochaine[g] != -1)
+            {
+                int cellule = prochaine[g];
+                for (int code = 1; code <= NOMBRE_DIRECTIONS; code++)
+                {
+                    Lien lien = partie->niveau->liens[cellule / HAUTEUR_TABLEAU_PLATEAU][cellule % HAUTEUR_TABLEAU_PLATEAU][code];
+                    if ((partie->zone[lien.x][lien.y] != zone) || (groupe[lien.x][lien.y] == g))
+                    {
+                        continue;
+                    }
+                    if (groupe[lien.x][lien.y] == NOMBRE_DIRECTIONS) // Case encore inexplorée : ajoutée au bout de la liste du parcours
+                    {
+                        int voisine = lien.x * HAUTEUR_TABLEAU_PLATEAU + lien.y;
+                        groupe[lien.x][lien.y] = g;
+                        suivante[voisine] = -1;
+                        suivante[derniere[g]] = voisine;
+                        derniere[g] = voisine;
+                        atteintes[g]++;
+                    }
+                    else if (trouverRacine(parents, groupe[lien.x][lien.y]) != trouverRacine(parents, g)) // Deux parcours se rencontrent : même morceau
+                    {
+                        parents[trouverRacine(parents, groupe[lien.x][lien.y])] = trouverRacine(parents, g);
+                        restants--;
+                    }
+                }
+                prochaine[g] = suivante[cellule];
+                epuisement |= (prochaine[g] == -1);
+            }
+        }
+        for (int racine = 0; (racine < nombreDeparts) && (restants > 1) && epuisement; racine++) // Morceaux entièrement parcourus
+        {
+            bool epuise = (termine[racine] == false) && (parents[racine] == racine);
+            for (int g = 0; g < nombreDeparts; g++)
+            {
+                epuise &= (trouverRacine(parents, g) != racine) || (prochaine[g] == -1);
+            }
+            if (epuise) // Morceau séparé : nouveau numéro
+            {
+                short nouvelle = nouvelleZone(partie);
+                for (int g = 0; g < nombreDeparts; g++)
+                {
+                    if (trouverRacine(parents, g) == racine)
+                    {
+                        for (int cellule = premiere[g]; cellule != -1; cellule = suivante[cellule])
+                        {
+                            partie->zone[cellule / HAUTEUR_TABLEAU_PLATEAU][cellule % HAUTEUR_TABLEAU_PLATEAU] = nouvelle;
+                        }
+                        partie->libresZone[zone] -= atteintes[g];
+                        partie->libresZone[nouvelle] += atteintes[g];
+                    }
+                }
+                termine[racine] = true;
+                restants--;
+            }
+        }
+    }
+}
+
+/**
+ * \fn void occuperCase(Partie *partie, int x, int y)
+ * \brief Ajoute un segment du serpent sur une case ; une case qui n'est plus libre quitte sa zone, qui peut être coupée en deux.
+ * 
+ * \param partie Partie en cours.
+ * \param x Coordonnée X de la case.
+ * \param y Coordonnée Y de la case.
+ */
+void occuperCase(Partie *partie, int x, int y) // Ajoute un segment du serpent sur une case
+{
+    if ((x >= 0) && (x < LARGEUR_TABLEAU_PLATEAU) && (y >= 0) && (y < HAUTEUR_TABLEAU_PLATEAU))
+    {
+        short zone = partie->zone[x][y];
+        partie->occupation[x][y]++;
+        if (zone != AUCUNE_ZONE) // La case n'est plus libre
+        {
+            partie->zone[x][y] = AUCUNE_ZONE;
+            partie->libresZone[zone]--;
+            partie->libresColonne[x] &= ~((uint64_t)1 << y);
+            separerZone(partie, x, y, zone);
+        }
+    }
+}
+
+/**
+ * \fn void libererCase(Partie *partie, int x, int y)
+ * \brief Retire un segment du serpent d'une case ; une case redevenue libre rejoint les zones voisines, qu'elle réunit.
+ * 
+ * Si les voisines libres se rejoignent autour de la case (groupesAutour()), elles sont déjà dans une seule zone.
+ * Sinon, les zones voisines prennent le numéro de la plus grande d'entre elles : seules les plus petites sont renumérotées.
+ * 
+ * \param partie Partie en cours.
+ * \param x Coordonnée X de la case.
+ * \param y Coordonnée Y de la case.
+ */
+void libererCase(Partie *partie, int x, int y) // Retire un segment du serpent d'une case
+{
+    if ((x >= 0) && (x < LARGEUR_TABLEAU_PLATEAU) && (y >= 0) && (y < HAUTEUR_TABLEAU_PLATEAU) && (partie->occupation[x][y] > 0))
+    {
+        partie->occupation[x][y]--;
+        if ((partie->occupation[x][y] == 0) && (x >= X_BORDURE_GAUCHE_PLATEAU) && (x <= X_BORDURE_DROITE_PLATEAU) && (y >= Y_BORDURE_HAUT_PLATEAU) && (y <= Y_BORDURE_BAS_PLATEAU)
+            && (caseObstacle(partie, x, y) == false)) // La case redevient libre
+        {
+            short zone = AUCUNE_ZONE;
+            unsigned int groupes = partie->niveau->geometrique[x][y] ? groupesAutour(partie, x, y) : 3; // 3 : deux groupes, réunion par les zones voisines
+            if ((groupes & (groupes - 1)) == 0) // Au plus un groupe : une seule zone voisine, celle de la première voisine du groupe
+            {
+                for (int k = 0; (k < 8) && (groupes != 0) && (zone == AUCUNE_ZONE); k += 2)
+                {
+                    zone = (groupes & (1u << k)) ? partie->zone[x + ANNEAU_X[k]][y + ANNEAU_Y[k]] : zone;
+                }
+                zone = (zone == AUCUNE_ZONE) ? nouvelleZone(partie) : zone; // Case isolée : nouvelle zone
+            }
+            else
+            {
+                short zones[NOMBRE_DIRECTIONS];
+                int nombreZones = zonesVoisines(partie, x, y, zones);
+                zone = (nombreZones == 0) ? nouvelleZone(partie) : zones[0]; // Case isolée : nouvelle zone
+                for (int i = 1; i < nombreZones; i++) // Garder le numéro de la plus grande zone voisine
+                {
+                    zone = (partie->libresZone[zones[i]] > partie->libresZone[zone]) ? zones[i] : zone;
+                }
+                for (int code = 1; (code <= NOMBRE_DIRECTIONS) && (nombreZones > 1); code++) // Réunir les autres zones voisines
+                {
+                    Lien lien = partie->niveau->liens[x][y][code];
+                    if ((partie->zone[lien.x][lien.y] != AUCUNE_ZONE) && (partie->zone[lien.x][lien.y] != zone))
+                    {
+                        renumeroterZone(partie, lien.x, lien.y, zone);
+                    }
+                }
+            }
+            partie->zone[x][y] = zone;
+            partie->libresZone[zone]++;
+            partie->libresColonne[x] |= (uint64_t)1 << y;
+        }
+    }
+}
+
+/**
+ * \fn int casesLibresAccessibles(const Partie *partie)
+ * \brief Nombre de cases libres que la tête peut atteindre, c'est-à-dire des zones voisines de la tête : une pomme peut encore y apparaître.
+ * 
+ * \param partie Partie en cours.
+ * \return Le nombre de cases libres accessibles, 0 si la tête est enfermée.
+ */
+int casesLibresAccessibles(const Partie *partie) // Nombre de cases libres accessibles depuis la tête
+{
+    short zones[NOMBRE_DIRECTIONS];
+    int nombreZones = 0;
+    int libres = 0;
+    if ((partie->lesX[0] >= 0) && (partie->lesX[0] < LARGEUR_TABLEAU_PLATEAU) && (partie->lesY[0] >= 0) && (partie->lesY[0] < HAUTEUR_TABLEAU_PLATEAU))
+    {
+        nombreZones = zonesVoisines(partie, partie->lesX[0], partie->lesY[0], zones);
+    }
+    for (int i = 0; i < nombreZones; i++)
+    {
+        libres += partie->libresZone[zones[i]];
+    }
+    return libres;
+}
+
+/**
+* \fn void initPlateau(Partie *partie)
 * \brief Initialise le plateau de jeu.
 *
 * Cette fonction crée le plateau de jeu en initialisant chaque case avec la valeur appropriée 
-* (bordure, espace vide). Elle ajoute également les obstacles (pavés) de manière aléatoire.
+* (bordure, espace vide), en ouvrant les bordures aux cases reliées par les portails du niveau. Elle ajoute également les obstacles (pavés) de manière aléatoire,
+* à partir du générateur aléatoire de la partie, puis découpe le plateau en zones (calculerZones()).
 *
-* @param coordPlateau Tableau à deux dimensions représentant le plateau de jeu.
-* Chaque élément du tableau correspond à une case du plateau et contient un caractère 
+* @param partie Partie dont le plateau est créé.
+* Chaque élément du tableau du plateau correspond à une case et contient un caractère 
 * représentant le contenu de la case (mur, espace vide, pomme, etc.).
 */
-void initPlateau(int coordPlateau[LARGEUR_TABLEAU_PLATEAU][HAUTEUR_TABLEAU_PLATEAU]) // Permert de créer le plateau de jeu aux dimensions souhaitées avec le nombre de pavés (obstacles) souhaités
+void initPlateau(Partie *partie) // Permert de créer le plateau de jeu aux dimensions souhaitées avec le nombre de pavés (obstacles) souhaités
 {
-    for (int i = DECALAGE; i < LARGEUR_TABLEAU_PLATEAU; i++) // Pour toute la largeur du plateau
+    for (int i = 0; i < LARGEUR_TABLEAU_PLATEAU; i++) // Pour toute la largeur du tableau (les rangs d'indice 0 hors plateau restent vides)
     {
-        for (int j = DECALAGE; j < HAUTEUR_TABLEAU_PLATEAU; j++) // Pour toute la hauteur du plateau
+        for (int j = 0; j < HAUTEUR_TABLEAU_PLATEAU; j++) // Pour toute la hauteur du tableau
         {
-            if (((i == X_BORDURE_GAUCHE_PLATEAU || i == X_BORDURE_DROITE_PLATEAU || j == Y_BORDURE_HAUT_PLATEAU || j == Y_BORDURE_BAS_PLATEAU)) && (((i != X_ISSUE_GAUCHE) || (j != Y_ISSUES_GAUCHE_DROITE)) && ((i != X_ISSUE_DROITE) || (j != Y_ISSUES_GAUCHE_DROITE)) && ((i != X_ISSUES_HAUT_BAS) || (j != Y_ISSUE_HAUT)) && ((i != X_ISSUES_HAUT_BAS) || (j != Y_ISSUE_BAS)))) // Vérifier que les coordonnées correspondent aux limites du plateau
+            if (((i == X_BORDURE_GAUCHE_PLATEAU || i == X_BORDURE_DROITE_PLATEAU || j == Y_BORDURE_HAUT_PLATEAU || j == Y_BORDURE_BAS_PLATEAU)) && (i >= DECALAGE) && (j >= DECALAGE)) // Vérifier que les coordonnées correspondent aux limites du plateau
             {
-                coordPlateau[i][j] = CARACTERE_PLATEAU; // Placer un caractère délimitant le plateau à cette position dans le tableau
+                partie->coordPlateau[i][j] = CARACTERE_PLATEAU; // Placer un caractère délimitant le plateau à cette position dans le tableau
             }
             else // Si ces coordonnées apparatiennent à la partie itérieure du plateau de jeu
             {
-                coordPlateau[i][j] = CARACTERE_VIDE; // Placer un caractère représentant le vide à cette position dans le tableau
+                partie->coordPlateau[i][j] = CARACTERE_VIDE; // Placer un caractère représentant le vide à cette position dans le tableau
             }
         }
     }
-    srand(time(NULL)); // Permet de générer différentes coordonnées aléatoires
+    for (int i = 0; i < partie->niveau->nombrePortails; i++) // Ouvrir les bordures aux cases reliées par un portail (issues)
+    {
+        const Portail *portail = &partie->niveau->portails[i];
+        partie->coordPlateau[portail->x1][portail->y1] = CARACTERE_VIDE;
+        partie->coordPlateau[portail->x2][portail->y2] = CARACTERE_VIDE;
+    }
     for (int i = 0; i < NOMBRE_DE_PAVES; i++) // Pour chaque pavé souhaité
     {
-        int x = (rand() % ((X_MAX_PAVE + 1) - X_MIN_PAVE)) + X_MIN_PAVE; // Générer une coordonnée X aléatoire pour le coin supérieur hauche du pavé, en évitant et en maintenant un écart avec les bords
-        int y = (rand() % ((Y_MAX_PAVE + 1) - Y_MIN_PAVE)) + Y_MIN_PAVE; // Générer une coordonnée Y aléatoire pour le coin supérieur hauche du pavé, en évitant et en maintenant un écart avec les bords
+        int x = (rand_r(&partie->graine) % ((X_MAX_PAVE + 1) - X_MIN_PAVE)) + X_MIN_PAVE; // Générer une coordonnée X aléatoire pour le coin supérieur hauche du pavé, en évitant et en maintenant un écart avec les bords
+        int y = (rand_r(&partie->graine) % ((Y_MAX_PAVE + 1) - Y_MIN_PAVE)) + Y_MIN_PAVE; // Générer une coordonnée Y aléatoire pour le coin supérieur hauche du pavé, en évitant et en maintenant un écart avec les bords
         // Conditions pour éviter les chevauchements avec le serpent au départ
         if ((y >= Y_INITIAL - (TAILLE_PAVE - 1)) && (y <= Y_INITIAL)) // Vérifier si la coordonnée Y d'un élément du pavé correspond à une coordonnée Y d'un élément du serpent
         {
@@ -890,22 +2106,26 @@ void initPlateau(int coordPlateau[LARGEUR_TABLEAU_PLATEAU][HAUTEUR_TABLEAU_PLATE
         {
             for (int k = 0; k < TAILLE_PAVE; k++) // Pour toute la hauteur du pavé
             {
-                coordPlateau[x + j][y + k] = CARACTERE_PAVE; // Placer un caractère représentant un pavé à la position correspondante dans le tableau
+                partie->coordPlateau[x + j][y + k] = CARACTERE_PAVE; // Placer un caractère représentant un pavé à la position correspondante dans le tableau
             }
         }
     }
-    dessinerPlateau(coordPlateau); // Permet de dessiner le plateau à partir du tableau comportant ses éléments aux positions définies
+    calculerZones(partie); // Repérer les zones que les pavés et les bordures séparent
+    if (partie->affichage) // Vérifier si la partie est affichée
+    {
+        dessinerPlateau(partie->coordPlateau); // Permet de dessiner le plateau à partir du tableau comportant ses éléments aux positions définies
+    }
 }
 
 /**
- * \fn void dessinerPlateau(int coordPlateau[LARGEUR_TABLEAU_PLATEAU][HAUTEUR_TABLEAU_PLATEAU])
+ * \fn void dessinerPlateau(char coordPlateau[LARGEUR_TABLEAU_PLATEAU][HAUTEUR_TABLEAU_PLATEAU])
  * \brief Dessine le plateau de jeu à partir du tableau des coordonnées.
  * 
  * Cette fonction parcourt le tableau du plateau et affiche chaque élément à sa position respective dans le terminal.
  * 
  * \param coordPlateau Plateau de jeu sous forme de tableau à deux dimensions.
  */
-void dessinerPlateau(int coordPlateau[LARGEUR_TABLEAU_PLATEAU][HAUTEUR_TABLEAU_PLATEAU]) // Permet de dessiner le plateau
+void dessinerPlateau(char coordPlateau[LARGEUR_TABLEAU_PLATEAU][HAUTEUR_TABLEAU_PLATEAU]) // Permet de dessiner le plateau
 {
     for (int i = 0; i < LARGEUR_TABLEAU_PLATEAU; i++) // Pour toute la largeur du plateau
     {
@@ -917,36 +2137,565 @@ void dessinerPlateau(int coordPlateau[LARGEUR_TABLEAU_PLATEAU][HAUTEUR_TABLEAU_P
 }
 
 /**
-* \fn void ajouterPomme(int coordPlateau[LARGEUR_TABLEAU_PLATEAU][HAUTEUR_TABLEAU_PLATEAU], int lesX[], int lesY[], int taille)
+* \fn void ajouterPomme(Partie *partie)
 * \brief Ajoute une pomme à une position aléatoire sur le plateau, en évitant les collisions avec le serpent et les obstacles.
 *
 * Cette fonction choisit aléatoirement une position libre sur le plateau et y place une pomme.
-* Elle vérifie que la position choisie ne correspond ni à une case occupée par le serpent, ni à un obstacle.
-* Si toutes les cases du plateau sont occupées, la fonction ne fait rien.
+* Elle vérifie que la position choisie ne correspond ni à une case occupée par le serpent, ni à un obstacle,
+* et qu'elle appartient à une zone voisine de la tête : une pomme enfermée par des pavés ou par le corps du serpent serait impossible à manger.
+* Après ESSAIS_MAX_POMME tirages infructueux, la pomme est choisie parmi les cases libres de la zone
+* situées dans le même cadre que les tirages (X_MIN_POMME à X_MAX_POMME, Y_MIN_POMME à Y_MAX_POMME) : jamais sur une issue des bordures.
+* Si les zones voisines de la tête n'ont plus de case libre dans ce cadre, aucune pomme n'est ajoutée.
 *
-* @param coordPlateau Tableau à deux dimensions représentant le plateau de jeu.
-* @param lesX Tableau des coordonnées X des segments du serpent.
-* @param lesY Tableau des coordonnées Y des segments du serpent.
-* @param taille Taille du serpent.
+* @param partie Partie en cours (plateau, serpent et générateur aléatoire).
 */
-void ajouterPomme(int coordPlateau[LARGEUR_TABLEAU_PLATEAU][HAUTEUR_TABLEAU_PLATEAU], int lesX[], int lesY[], int taille) // Permet de faire apparaître une pomme à une position aléatoire sur le plateau de jeu et de l'ajouter au tableau des coordonnées du plateau
+void ajouterPomme(Partie *partie) // Permet de faire apparaître une pomme à une position aléatoire sur le plateau de jeu et de l'ajouter au tableau des coordonnées du plateau
 {
     int x = 0; // Initialisation de la coordonée x de la pomme à 0
     int y = 0; // Initialisation de la coordonée y de la pomme à 0
-    bool superposition = false; // Initialisation du booléen superposition à false
-    while ((coordPlateau[x][y] != CARACTERE_VIDE) || (superposition == true)) // Tant que la position de la pomme ne correspond pas à un espace vide du plateau ou qu'elle se superpose avec le serpent
+    short zonesTete[NOMBRE_DIRECTIONS]; // Zones dans lesquelles la pomme doit apparaître : celles des voisines de la tête
+    int nombreZones = zonesVoisines(partie, partie->lesX[0], partie->lesY[0], zonesTete);
+    bool trouvee = false; // Initialisation du booléen trouvee à false
+    if (casesLibresAccessibles(partie) == 0) // Vérifier qu'il reste une case libre accessible
+    {
+        return;
+    }
+    for (int essai = 0; (essai < ESSAIS_MAX_POMME) && (trouvee == false); essai++) // Tant que la position de la pomme ne correspond pas à un espace vide de la zone de la tête ou qu'elle se superpose avec le serpent
+    {
+        x = (rand_r(&partie->graine) % ((X_MAX_POMME + 1) - X_MIN_POMME)) + X_MIN_POMME; // Générée une position x de la pomme aléatoirement dans le plateau
+        y = (rand_r(&partie->graine) % ((Y_MAX_POMME + 1) - Y_MIN_POMME)) + Y_MIN_POMME; // Générée une position y de la pomme aléatoirement dans le plateau
+        trouvee = (partie->coordPlateau[x][y] == CARACTERE_VIDE) && zoneParmi(partie->zone[x][y], zonesTete, nombreZones); // Une case d'une zone est libre
+    }
+    if (trouvee == false) // Choisir directement parmi les cases libres de la zone, dans le même cadre que les tirages
+    {
+        int candidates = 0; // Cases libres de la zone dans le cadre (les issues des bordures en sont exclues)
+        for (int i = X_MIN_POMME; i <= X_MAX_POMME; i++)
+        {
+            for (int j = Y_MIN_POMME; j <= Y_MAX_POMME; j++)
+            {
+                candidates += zoneParmi(partie->zone[i][j], zonesTete, nombreZones);
+            }
+        }
+        if (candidates == 0) // Seules des issues restent libres : pas de pomme
+        {
+            return;
+        }
+        int rang = rand_r(&partie->graine) % candidates; // Rang de la case libre choisie
+        for (int i = X_MIN_POMME; (i <= X_MAX_POMME) && (trouvee == false); i++)
+        {
+            for (int j = Y_MIN_POMME; (j <= Y_MAX_POMME) && (trouvee == false); j++)
+            {
+                if (zoneParmi(partie->zone[i][j], zonesTete, nombreZones))
+                {
+                    x = i;
+                    y = j;
+                    trouvee = (rang == 0);
+                    rang--;
+                }
+            }
+        }
+    }
+    partie->coordPlateau[x][y] = POMME; // Intégrer la pomme au tableau des coordonnées des éléments du plateau
+    partie->xPomme = x; // Mémoriser la position de la pomme
+    partie->yPomme = y;
+    if (partie->affichage) // Vérifier si la partie est affichée
+    {
+        afficher(x, y, POMME); // afficher la pomme dans le plateau de jeu
+    }
+}
+
+/**
+* \fn void initPartie(Partie *partie, const Niveau *niveau, unsigned int graine, bool affichage)
+* \brief Prépare une partie complète : serpent initial, plateau et première pomme.
+*
+* Deux parties initialisées avec la même graine sont identiques (même plateau, mêmes pommes
+* pour les mêmes mouvements), ce qui permet de comparer des bots sur les mêmes parties.
+*
+* @param partie Partie à initialiser.
+* @param niveau Niveau de la partie, préparé par exemple avec initNiveauStandard() ; il doit rester valide pendant toute la partie.
+* @param graine Graine du générateur aléatoire de la partie.
+* @param affichage true pour dessiner la partie dans le terminal, false pour une simulation.
+*/
+void initPartie(Partie *partie, const Niveau *niveau, unsigned int graine, bool affichage) // Prépare une partie complète : serpent initial, plateau et première pomme
+{
+    partie->niveau = niveau;
+    partie->graine = graine; // Initialiser le générateur aléatoire de la partie
+    partie->affichage = affichage;
+    partie->taille = TAILLE_INITIALE_SERPENT; // Initialisation de la taille du serpent
+    partie->score = 0; // Initialisation du score
+    partie->tours = 0;
+    partie->direction = DIRECTION_INITIALE;
+    partie->collision = false;
+    for (int i = 0; i < TAILLE_MAX_SERPENT; i++) // Initialiser les coordonnées X et Y de la tête et du corps du serpent
+    {
+        partie->lesX[i] = X_INITIAL - i;
+        partie->lesY[i] = Y_INITIAL;
+    }
+    initPlateau(partie); // Créer le plateau de jeu
+    memset(partie->occupation, 0, sizeof(partie->occupation));
+    for (int i = 0; i < partie->taille; i++) // Placer le serpent sur le plateau
+    {
+        occuperCase(partie, partie->lesX[i], partie->lesY[i]);
+    }
+    ajouterPomme(partie); // Faire apparaître la première pomme
+    if (affichage) // Vérifier si la partie est affichée
+    {
+        dessinerSerpent(partie->lesX, partie->lesY, partie->taille); // Dessiner le serpent dans le terminal
+    }
+}
+
+/**
+* \fn bool jouerTour(Partie *partie, char direction)
+* \brief Joue un mouvement et applique ses conséquences.
+*
+* Fait progresser le serpent ; si une pomme est mangée, le score augmente et une nouvelle pomme
+* apparaît tant que la partie n'est pas gagnée.
+*
+* @param partie Partie en cours.
+* @param direction Direction du mouvement (RIGHT, LEFT, UP, DOWN).
+* @return true si une pomme a été mangée, false sinon.
+*/
+bool jouerTour(Partie *partie, char direction) // Joue un mouvement et applique ses conséquences (score, nouvelle pomme)
+{
+    bool mangee = progresser(partie, direction); // Faire progresser le serpent
+    partie->tours++;
+    if (mangee) // Si le serpent a mangé une pomme
+    {
+        partie->score++; // Le score augmente de 1
+        if (partie->score < NOMBRE_DE_POMMES) // Si le score est inférieur au nombre de pommes
+        {
+            ajouterPomme(partie); // Faire apparaître une nouvelle pomme
+        }
+    }
+    return mangee;
+}
+
+/**
+* \fn bool partieTerminee(const Partie *partie)
+* \brief Indique si la partie est terminée.
+*
+* @param partie Partie en cours.
+* @return true en cas de collision ou lorsque toutes les pommes ont été mangées, false sinon.
+*/
+bool partieTerminee(const Partie *partie) // Indique si la partie est terminée (collision ou victoire)
+{
+    return (partie->collision) || (partie->score == NOMBRE_DE_POMMES);
+}
+
+/**
+* \fn void reinitialiserPartie(Partie *partie, const Partie *gabarit)
+* \brief Remet une partie dans l'état d'un gabarit préparé avec initPartie().
+*
+* La partie obtenue est identique à celle que donnerait initPartie() avec la graine du gabarit,
+* pour le coût d'une seule copie mémoire : le plateau n'est pas reconstruit et aucune pomme n'est tirée.
+*
+* @param partie Partie à réinitialiser.
+* @param gabarit Partie initialisée servant de modèle.
+*/
+void reinitialiserPartie(Partie *partie, const Partie *gabarit) // Remet une partie dans l'état d'un gabarit préparé avec initPartie()
+{
+    memcpy(partie, gabarit, sizeof(Partie));
+}
+
+/**
+* \fn bool creerPool(PoolParties *pool, int capacite)
+* \brief Réserve un nombre fixe de parties en une seule fois.
+*
+* @param pool Réserve à créer.
+* @param capacite Nombre de parties de la réserve.
+* @return true si la réserve a été créée, false en cas d'échec de l'allocation.
+*/
+bool creerPool(PoolParties *pool, int capacite) // Réserve un nombre fixe de parties
+{
+    pool->parties = malloc(sizeof(Partie) * capacite);
+    pool->libres = malloc(sizeof(Partie *) * capacite);
+    if ((pool->parties == NULL) || (pool->libres == NULL))
+    {
+        free(pool->parties);
+        free(pool->libres);
+        return false;
+    }
+    for (int i = 0; i < capacite; i++) // Toutes les parties sont disponibles
+    {
+        pool->libres[i] = &pool->parties[capacite - 1 - i];
+    }
+    pool->nombreLibres = capacite;
+    pool->capacite = capacite;
+    return true;
+}
+
+/**
+* \fn Partie *prendrePartie(PoolParties *pool)
+* \brief Prend une partie disponible dans la réserve, sans allocation.
+*
+* La partie prise n'est pas initialisée : utiliser initPartie() ou reinitialiserPartie().
+*
+* @param pool Réserve de parties.
+* @return Une partie disponible, ou NULL si la réserve est vide.
+*/
+Partie *prendrePartie(PoolParties *pool) // Prend une partie disponible dans la réserve
+{
+    Partie *partie = NULL;
+    if (pool->nombreLibres > 0)
+    {
+        pool->nombreLibres--;
+        partie = pool->libres[pool->nombreLibres];
+    }
+    return partie;
+}
+
+/**
+* \fn void rendrePartie(PoolParties *pool, Partie *partie)
+* \brief Rend à la réserve une partie prise avec prendrePartie().
+*
+* @param pool Réserve de parties.
+* @param partie Partie rendue.
+*/
+void rendrePartie(PoolParties *pool, Partie *partie) // Rend une partie à la réserve
+{
+    pool->libres[pool->nombreLibres] = partie;
+    pool->nombreLibres++;
+}
+
+/**
+* \fn void detruirePool(PoolParties *pool)
+* \brief Libère la réserve et toutes ses parties.
+*
+* @param pool Réserve de parties.
+*/
+void detruirePool(PoolParties *pool) // Libère la réserve
+{
+    free(pool->parties);
+    free(pool->libres);
+    pool->parties = NULL;
+    pool->libres = NULL;
+    pool->nombreLibres = 0;
+    pool->capacite = 0;
+}
+
+/**
+* \fn bool ouvrirDiffusion(const char *chemin)
+* \brief Ouvre la socket locale sur laquelle les spectateurs se connectent pour suivre la partie.
+*
+* La socket conserve les limites des trames (SOCK_SEQPACKET) : une trame est envoyée entière ou pas du tout,
+* ce qui permet d'abandonner les trames d'un spectateur en retard sans corrompre son flux.
+*
+* @param chemin Chemin de la socket (une socket existante est remplacée, tout autre fichier est refusé).
+* @return true si la socket est ouverte, false sinon.
+*/
+bool ouvrirDiffusion(const char *chemin) // Ouvre la socket de diffusion de la partie aux spectateurs
+{
+    struct sockaddr_un adresse = {.sun_family = AF_UNIX};
+    if (strlen(chemin) >= sizeof(adresse.sun_path))
+    {
+        errno = ENAMETOOLONG;
+        return false;
+    }
+    strcpy(adresse.sun_path, chemin);
+    struct stat existant;
+    if (lstat(chemin, &existant) == 0) // Ne remplacer qu'une socket laissée par une partie précédente
+    {
+        if (S_ISSOCK(existant.st_mode) == false)
+        {
+            errno = EEXIST; // Un fichier qui n'est pas une socket n'est jamais supprimé
+            return false;
+        }
+        unlink(chemin);
+    }
+    diffusion.serveur = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_NONBLOCK, 0);
+    if ((diffusion.serveur < 0) || (bind(diffusion.serveur, (struct sockaddr *)&adresse, sizeof(adresse)) != 0) || (listen(diffusion.serveur, SPECTATEURS_MAX) != 0))
     {
-        superposition = false; // Mettre la variable booléenne superposition à false
-        x = (rand() % ((X_MAX_POMME + 1) - X_MIN_POMME)) + X_MIN_POMME; // Générée une position x de la pomme aléatoirement dans le plateau
-        y = (rand() % ((Y_MAX_POMME + 1) - Y_MIN_POMME)) + Y_MIN_POMME; // Générée une position y de la pomme aléatoirement dans le plateau
-        for (int i = 0; i < taille; i++) // Vérifier la superposition entre le serpent et la pomme
+        if (diffusion.serveur >= 0)
         {
-            if ((lesX[i] == x) && (lesY[i] == y))
+            close(diffusion.serveur);
+        }
+        diffusion.serveur = -1;
+        return false;
+    }
+    diffusion.chemin = chemin;
+    diffusion.nombreSpectateurs = 0;
+    diffusion.nombreChangements = 0;
+    diffusion.debordement = false;
+    memset(diffusion.ecran, CARACTERE_VIDE, sizeof(diffusion.ecran));
+    return true;
+}
+
+/**
+* \fn void noterCase(int x, int y, char c)
+* \brief Mémorise une case affichée dans la copie de l'écran et, si elle a changé, dans les changements du tour.
+*
+* Le serpent est entièrement redessiné à chaque tour, mais seules les cases dont le caractère change
+* sont transmises (ancienne queue, ancienne et nouvelle tête, pomme).
+*
+* @param x Coordonnée X de la case.
+* @param y Coordonnée Y de la case.
+* @param c Caractère affiché.
+*/
+void noterCase(int x, int y, char c) // Mémorise une case affichée pour les spectateurs
+{
+    if ((diffusion.serveur < 0) || (x < 0) || (x >= LARGEUR_TABLEAU_PLATEAU) || (y < 0) || (y >= HAUTEUR_TABLEAU_PLATEAU) || (diffusion.ecran[x][y] == c))
+    {
+        return;
+    }
+    diffusion.ecran[x][y] = c;
+    if (diffusion.nombreChangements < CHANGEMENTS_MAX_TOUR)
+    {
+        unsigned char *changement = &diffusion.changements[3 * diffusion.nombreChangements];
+        changement[0] = x;
+        changement[1] = y;
+        changement[2] = c;
+        diffusion.nombreChangements++;
+    }
+    else // Trop de changements : la trame de changements est remplacée par une image complète
+    {
+        diffusion.debordement = true;
+    }
+}
+
+/**
+* \fn int encoderImage(unsigned char trame[], long tour)
+* \brief Encode l'image complète de l'écran dans une trame, compressée par plages de caractères identiques.
+*
+* @param trame Trame à remplir (TAILLE_TRAME_MAX octets).
+* @param tour Numéro du tour.
+* @return La taille de la trame en octets.
+*/
+int encoderImage(unsigned char trame[], long tour) // Encode l'image complète de l'écran dans une trame
+{
+    int taille = 0;
+    trame[taille++] = TRAME_IMAGE;
+    for (int i = 0; i < 4; i++) // Numéro du tour, octet de poids faible en premier
+    {
+        trame[taille++] = (unsigned long)tour >> (8 * i);
+    }
+    trame[taille++] = LARGEUR_TABLEAU_PLATEAU;
+    trame[taille++] = HAUTEUR_TABLEAU_PLATEAU;
+    for (int y = 0; y < HAUTEUR_TABLEAU_PLATEAU; y++) // Plages (nombre, caractère), rangée par rangée
+    {
+        int x = 0;
+        while (x < LARGEUR_TABLEAU_PLATEAU)
+        {
+            int longueur = 1;
+            while ((x + longueur < LARGEUR_TABLEAU_PLATEAU) && (longueur < 255) && (diffusion.ecran[x + longueur][y] == diffusion.ecran[x][y]))
             {
-                superposition = true; // Mettre la variable booléenne superposition à true
+                longueur++;
             }
+            trame[taille++] = longueur;
+            trame[taille++] = diffusion.ecran[x][y];
+            x += longueur;
+        }
+    }
+    return taille;
+}
+
+/**
+* \fn void diffuserTour(long tour)
+* \brief Accepte les nouveaux spectateurs et leur envoie les changements du tour.
+*
+* Les nouveaux spectateurs, ainsi que ceux dont le tampon était plein au tour précédent, reçoivent l'image
+* complète la plus récente ; les autres reçoivent la trame de changements. Les envois ne bloquent jamais :
+* une trame qui ne tient pas dans le tampon d'un spectateur est abandonnée et le spectateur attend une image.
+* Les trames ne sont encodées qu'une fois par tour, quel que soit le nombre de spectateurs.
+*
+* @param tour Numéro du tour qui vient d'être joué.
+*/
+void diffuserTour(long tour) // Envoie les changements du tour aux spectateurs
+{
+    static unsigned char image[TAILLE_TRAME_MAX]; // Image complète, encodée si au moins un spectateur l'attend
+    unsigned char trame[5 + 3 * CHANGEMENTS_MAX_TOUR]; // Trame de changements
+    int tailleImage = 0;
+    int tailleTrame = 0;
+    int spectateur;
+    if (diffusion.serveur < 0)
+    {
+        return;
+    }
+    while ((spectateur = accept(diffusion.serveur, NULL, NULL)) >= 0) // Accepter les nouveaux spectateurs
+    {
+        int tampon = TAMPON_SPECTATEUR;
+        if (diffusion.nombreSpectateurs == SPECTATEURS_MAX)
+        {
+            close(spectateur);
+            continue;
+        }
+        setsockopt(spectateur, SOL_SOCKET, SO_SNDBUF, &tampon, sizeof(tampon));
+        diffusion.spectateurs[diffusion.nombreSpectateurs] = spectateur;
+        diffusion.enRetard[diffusion.nombreSpectateurs] = true; // Commencer par une image complète
+        diffusion.nombreSpectateurs++;
+    }
+    trame[tailleTrame++] = TRAME_CHANGEMENTS;
+    for (int i = 0; i < 4; i++)
+    {
+        trame[tailleTrame++] = (unsigned long)tour >> (8 * i);
+    }
+    memcpy(&trame[tailleTrame], diffusion.changements, 3 * diffusion.nombreChangements);
+    tailleTrame += 3 * diffusion.nombreChangements;
+    for (int i = 0; i < diffusion.nombreSpectateurs; i++)
+    {
+        bool enRetard = diffusion.enRetard[i] || diffusion.debordement;
+        if ((enRetard == false) && (diffusion.nombreChangements == 0)) // Rien de nouveau pour ce spectateur
+        {
+            continue;
+        }
+        if (enRetard && (tailleImage == 0))
+        {
+            tailleImage = encoderImage(image, tour);
+        }
+        ssize_t envoye = enRetard ? send(diffusion.spectateurs[i], image, tailleImage, MSG_DONTWAIT | MSG_NOSIGNAL)
+                                  : send(diffusion.spectateurs[i], trame, tailleTrame, MSG_DONTWAIT | MSG_NOSIGNAL);
+        if (envoye >= 0) // Trame envoyée entière
+        {
+            diffusion.enRetard[i] = false;
+        }
+        else if ((errno == EAGAIN) || (errno == EWOULDBLOCK) || (errno == ENOBUFS)) // Tampon plein : sauter jusqu'à la prochaine image
+        {
+            diffusion.enRetard[i] = true;
+        }
+        else // Spectateur déconnecté : le remplacer par le dernier
+        {
+            close(diffusion.spectateurs[i]);
+            diffusion.nombreSpectateurs--;
+            diffusion.spectateurs[i] = diffusion.spectateurs[diffusion.nombreSpectateurs];
+            diffusion.enRetard[i] = diffusion.enRetard[diffusion.nombreSpectateurs];
+            i--;
         }
     }
-    coordPlateau[x][y] = POMME; // Intégrer la pomme au tableau des coordonnées des éléments du plateau
-    afficher(x, y, POMME); // afficher la pomme dans le plateau de jeu
-}
\ No newline at end of file
+    diffusion.nombreChangements = 0;
+    diffusion.debordement = false;
+}
+
+/**
+* \fn void fermerDiffusion()
+* \brief Ferme la diffusion : les spectateurs voient la fin de la partie, puis la socket est supprimée.
+*/
+void fermerDiffusion() // Ferme la diffusion et déconnecte les spectateurs
+{
+    if (diffusion.serveur < 0)
+    {
+        return;
+    }
+    for (int i = 0; i < diffusion.nombreSpectateurs; i++)
+    {
+        close(diffusion.spectateurs[i]);
+    }
+    close(diffusion.serveur);
+    unlink(diffusion.chemin);
+    diffusion.serveur = -1;
+    diffusion.nombreSpectateurs = 0;
+}
+
+/**
+* \fn long nanosecondes()
+* \brief Temps écoulé depuis une origine fixe (horloge monotone, lue sans appel système).
+*
+* @return Le temps en nanosecondes.
+*/
+long nanosecondes() // Temps écoulé (horloge monotone), en nanosecondes
+{
+    struct timespec instant;
+    clock_gettime(CLOCK_MONOTONIC, &instant);
+    return instant.tv_sec * 1000000000L + instant.tv_nsec;
+}
+
+/**
+* \fn bool ouvrirEtatPartage()
+* \brief Crée le segment de mémoire partagée /snake-<pid> dans lequel l'état de la partie est publié.
+*
+* @return true si le segment est créé, false sinon (l'état n'est alors pas publié).
+*/
+bool ouvrirEtatPartage() // Crée le segment de mémoire partagée de la partie
+{
+    snprintf(nomSegmentEtat, sizeof(nomSegmentEtat), "%s%d", PREFIXE_ETAT_PARTAGE, (int)getpid());
+    shm_unlink(nomSegmentEtat); // Segment laissé par un ancien processus de même PID
+    int descripteur = shm_open(nomSegmentEtat, O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (descripteur < 0)
+    {
+        return false;
+    }
+    if (ftruncate(descripteur, sizeof(SegmentEtat)) == 0)
+    {
+        segmentEtat = mmap(NULL, sizeof(SegmentEtat), PROT_READ | PROT_WRITE, MAP_SHARED, descripteur, 0);
+    }
+    close(descripteur);
+    if ((segmentEtat == NULL) || (segmentEtat == MAP_FAILED))
+    {
+        segmentEtat = NULL;
+        shm_unlink(nomSegmentEtat);
+        return false;
+    }
+    segmentEtat->pid = getpid(); // Segment neuf : rempli de zéros, séquence paire
+    segmentEtat->magie = MAGIE_ETAT_PARTAGE;
+    return true;
+}
+
+/**
+* \fn void publierEtat(EtatPartie *etat, const Partie *partie, int tempsAttente)
+* \brief Complète l'état avec la partie et le publie dans le segment sous le verrou séquentiel.
+*
+* Quelques écritures en mémoire : aucun appel système et aucune attente des lecteurs.
+*
+* @param etat État à publier (temps des phases déjà à jour).
+* @param partie Partie en cours.
+* @param tempsAttente Temps d'attente entre deux tours, en microsecondes.
+*/
+void publierEtat(EtatPartie *etat, const Partie *partie, int tempsAttente) // Publie l'état de la partie dans le segment
+{
+    if (segmentEtat == NULL)
+    {
+        return;
+    }
+    etat->tours = partie->tours;
+    etat->xTete = partie->lesX[0];
+    etat->yTete = partie->lesY[0];
+    etat->taille = partie->taille;
+    etat->score = partie->score;
+    etat->tempsAttente = tempsAttente;
+    etat->xPomme = partie->xPomme;
+    etat->yPomme = partie->yPomme;
+    uint32_t sequence = atomic_load_explicit(&segmentEtat->sequence, memory_order_relaxed);
+    atomic_store_explicit(&segmentEtat->sequence, sequence + 1, memory_order_relaxed); // Impair : écriture en cours
+    atomic_thread_fence(memory_order_release); // Le compteur impair est visible avant l'état
+    memcpy(&segmentEtat->etat, etat, sizeof(EtatPartie));
+    atomic_store_explicit(&segmentEtat->sequence, sequence + 2, memory_order_release); // Pair : l'état est visible avant le compteur
+}
+
+/**
+* \fn bool lireEtatPartage(const SegmentEtat *segment, EtatPartie *etat)
+* \brief Copie l'état d'un segment, en recommençant tant qu'une écriture l'a modifié pendant la copie.
+*
+* @param segment Segment d'une partie (projeté en lecture).
+* @param etat Copie cohérente de l'état.
+* @return true si une copie cohérente a été obtenue, false si le jeu écrivait à chaque essai.
+*/
+bool lireEtatPartage(const SegmentEtat *segment, EtatPartie *etat) // Copie un état cohérent depuis un segment
+{
+    for (int essai = 0; essai < 1000; essai++)
+    {
+        uint32_t avant = atomic_load_explicit(&segment->sequence, memory_order_acquire);
+        if ((avant & 1) == 0) // Aucune écriture en cours
+        {
+            memcpy(etat, &segment->etat, sizeof(EtatPartie));
+            atomic_thread_fence(memory_order_acquire); // La copie est terminée avant la relecture du compteur
+            if (atomic_load_explicit(&segment->sequence, memory_order_relaxed) == avant)
+            {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+/**
+* \fn void fermerEtatPartage()
+* \brief Supprime le segment de mémoire partagée de la partie.
+*/
+void fermerEtatPartage() // Supprime le segment de mémoire partagée de la partie
+{
+    if (segmentEtat == NULL)
+    {
+        return;
+    }
+    munmap(segmentEtat, sizeof(SegmentEtat));
+    shm_unlink(nomSegmentEtat);
+    segmentEtat = NULL;
+}
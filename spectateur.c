@@ -0,0 +1,154 @@
+/**
+* \page Spectateur
+* \brief Spectateur d'une partie de Snake diffusée sur une socket locale.
+* \author Ewen THÉPOT
+*
+* Le jeu diffuse sa partie lorsqu'il est lancé avec un chemin de socket (./snake /tmp/snake.sock).
+* Le spectateur reçoit d'abord une image complète du plateau, puis à chaque tour les seules cases modifiées.
+* S'il ne lit pas assez vite, le jeu abandonne ses trames en retard et lui renvoie une image complète :
+* le spectateur saute alors directement à l'état le plus récent de la partie.
+*
+* Utilisation : ./spectateur <socket>
+*/
+
+#define SNAKE_SANS_MAIN // Réutiliser l'affichage du jeu sans son programme principal
+#include "snake.c"
+
+// ----------------------------- CONSTANTES -------------------------------------
+
+/**
+ *
+ * \def MESSAGE_FIN_DIFFUSION
+ *
+ * \brief constante pour le message affiché lorsque la diffusion s'arrête
+ *
+ */
+#define MESSAGE_FIN_DIFFUSION "Fin de la diffusion\n" // Message de fin
+
+
+// Prototypes des fonctions
+long lireTour(const unsigned char trame[], int taille); // Lit le numéro de tour d'une trame
+bool afficherImage(const unsigned char trame[], int taille); // Dessine une image complète reçue
+void afficherChangements(const unsigned char trame[], int taille); // Dessine les cases modifiées reçues
+
+
+// Programme principal
+
+/**
+* \fn int main(int argc, char *argv[])
+* \brief Se connecte à une partie diffusée et la dessine jusqu'à la fin de la diffusion.
+*
+* \param argc Nombre d'arguments.
+* \param argv Arguments : chemin de la socket de diffusion.
+* \return 0 en cas de succès, une autre valeur en cas d'erreur.
+*/
+int main(int argc, char *argv[])
+{
+    struct sockaddr_un adresse = {.sun_family = AF_UNIX};
+    unsigned char trame[TAILLE_TRAME_MAX]; // Dernière trame reçue
+    long images = 0; // Nombre d'images complètes reçues (1 + nombre de retards rattrapés)
+    long tours = 0; // Dernier tour reçu
+    ssize_t taille;
+    if ((argc < 2) || (strlen(argv[1]) >= sizeof(adresse.sun_path)))
+    {
+        fprintf(stderr, "Utilisation : %s <socket>\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    strcpy(adresse.sun_path, argv[1]);
+    int connexion = socket(AF_UNIX, SOCK_SEQPACKET, 0);
+    if ((connexion < 0) || (connect(connexion, (struct sockaddr *)&adresse, sizeof(adresse)) != 0))
+    {
+        perror(argv[1]);
+        return EXIT_FAILURE;
+    }
+    while ((taille = recv(connexion, trame, sizeof(trame), 0)) > 0) // Une trame entière par lecture
+    {
+        if ((trame[0] == TRAME_IMAGE) && afficherImage(trame, taille))
+        {
+            images++;
+        }
+        else if (trame[0] == TRAME_CHANGEMENTS)
+        {
+            afficherChangements(trame, taille);
+        }
+        long tour = lireTour(trame, taille);
+        tours = (tour >= 0) ? tour : tours; // Trame trop courte : garder le dernier tour reçu
+        fflush(stdout);
+    }
+    close(connexion);
+    gotoXY(1, (HAUTEUR_PLATEAU + 1)); // Aller sous le plateau de jeu
+    printf("%s", MESSAGE_FIN_DIFFUSION);
+    printf("%ld tours suivis, %ld images complètes reçues\n", tours, images);
+    return EXIT_SUCCESS;
+}
+
+
+// Fonctions
+
+/**
+ * \fn long lireTour(const unsigned char trame[], int taille)
+ * \brief Lit le numéro de tour d'une trame (4 octets après son type, octet de poids faible en premier).
+ *
+ * \param trame Trame reçue.
+ * \param taille Taille de la trame en octets.
+ * \return Le numéro du tour, -1 si la trame est trop courte pour en contenir un.
+ */
+long lireTour(const unsigned char trame[], int taille) // Lit le numéro de tour d'une trame
+{
+    if (taille < 5) // Type et numéro du tour
+    {
+        return -1;
+    }
+    return (long)trame[1] | ((long)trame[2] << 8) | ((long)trame[3] << 16) | ((long)trame[4] << 24);
+}
+
+/**
+ * \fn bool afficherImage(const unsigned char trame[], int taille)
+ * \brief Efface le terminal et dessine l'image complète d'une trame TRAME_IMAGE.
+ *
+ * \param trame Trame reçue.
+ * \param taille Taille de la trame en octets.
+ * \return true si l'image a été dessinée, false si ses dimensions ne correspondent pas au plateau.
+ */
+bool afficherImage(const unsigned char trame[], int taille) // Dessine une image complète reçue
+{
+    if ((taille < 7) || (trame[5] != LARGEUR_TABLEAU_PLATEAU) || (trame[6] != HAUTEUR_TABLEAU_PLATEAU))
+    {
+        return false;
+    }
+    printf("\033[2J"); // Effacer le terminal
+    int x = 0;
+    int y = 0;
+    for (int i = 7; (i + 1 < taille) && (y < HAUTEUR_TABLEAU_PLATEAU); i += 2) // Plages (nombre, caractère)
+    {
+        for (int n = 0; n < trame[i]; n++)
+        {
+            if (trame[i + 1] != CARACTERE_VIDE)
+            {
+                afficher(x, y, trame[i + 1]);
+            }
+            x++;
+            if (x == LARGEUR_TABLEAU_PLATEAU) // Rangée suivante
+            {
+                x = 0;
+                y++;
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * \fn void afficherChangements(const unsigned char trame[], int taille)
+ * \brief Dessine les cases modifiées d'une trame TRAME_CHANGEMENTS.
+ *
+ * \param trame Trame reçue.
+ * \param taille Taille de la trame en octets.
+ */
+void afficherChangements(const unsigned char trame[], int taille) // Dessine les cases modifiées reçues
+{
+    for (int i = 5; i + 2 < taille; i += 3) // (x, y, caractère)
+    {
+        afficher(trame[i], trame[i + 1], trame[i + 2]);
+    }
+}
@@ -0,0 +1,427 @@
+/**
+* \page Telemetrie
+* \brief Export binaire en colonnes des résultats de parties simulées (et d'échantillons pris pendant les parties).
+* \author Ewen THÉPOT
+*
+* Le fichier est une suite de blocs, toujours ajoutés à la fin (plusieurs lancements peuvent écrire dans le même fichier).
+* Chaque bloc commence par un en-tête EnteteBloc, suivi de ses colonnes rangées l'une après l'autre
+* (toutes les valeurs d'une colonne, puis toutes celles de la suivante), dans l'ordre des octets de la machine :
+*  - BLOC_NOMS : noms des bots (chaînes terminées par un '\0'), pour les blocs qui suivent ;
+*  - BLOC_PARTIES : graine (32 bits), bot (8 bits), score (16 bits), taille finale (16 bits), tours (32 bits), cause de la fin (8 bits) ;
+*  - BLOC_ECHANTILLONS : graine (32 bits), bot (8 bits), tour (32 bits), X et Y de la tête (8 bits), taille (16 bits), score (16 bits).
+*
+* Chaque thread remplit ses propres colonnes en mémoire (aucun formatage de texte) et les écrit d'un seul appel
+* (writev) lorsqu'elles sont pleines, seul moment où les threads se partagent le fichier.
+*
+* Ce fichier est inclus après snake.c par les outils de simulation (tournament) et par le lecteur bilan.
+*/
+
+#include <stdint.h>
+#include <fcntl.h> // Pour open()
+#include <pthread.h> // Pour partager le fichier entre les threads
+#include <sys/uio.h> // Pour writev()
+
+// ----------------------------- CONSTANTES -------------------------------------
+
+/**
+ *
+ * \def VERSION_TELEMETRIE
+ *
+ * \brief constante pour la version du format des blocs
+ *
+ */
+#define VERSION_TELEMETRIE 2 // Version du format (2 : fin par la limite de tours distinguée de la victoire)
+
+/**
+ *
+ * \def BLOC_NOMS
+ *
+ * \brief constante pour le type des blocs de noms des bots
+ *
+ */
+#define BLOC_NOMS 'N' // Noms des bots
+
+/**
+ *
+ * \def BLOC_PARTIES
+ *
+ * \brief constante pour le type des blocs de résultats de parties
+ *
+ */
+#define BLOC_PARTIES 'P' // Une ligne par partie
+
+/**
+ *
+ * \def BLOC_ECHANTILLONS
+ *
+ * \brief constante pour le type des blocs d'échantillons pris pendant les parties
+ *
+ */
+#define BLOC_ECHANTILLONS 'E' // Une ligne par échantillon
+
+/**
+ *
+ * \def LIGNES_BLOC
+ *
+ * \brief constante pour le nombre de lignes accumulées en mémoire avant l'écriture d'un bloc
+ *
+ */
+#define LIGNES_BLOC 4096 // Nombre maximum de lignes d'un bloc
+
+/**
+ *
+ * \def COLONNES_PARTIES
+ *
+ * \brief constante pour le nombre de colonnes d'un bloc de parties
+ *
+ */
+#define COLONNES_PARTIES 6 // graine, bot, score, taille, tours, cause
+
+/**
+ *
+ * \def OCTETS_LIGNE_PARTIE
+ *
+ * \brief constante pour la taille en octets d'une ligne d'un bloc de parties
+ *
+ */
+#define OCTETS_LIGNE_PARTIE (4 + 1 + 2 + 2 + 4 + 1) // Somme des tailles des colonnes
+
+/**
+ *
+ * \def COLONNES_ECHANTILLONS
+ *
+ * \brief constante pour le nombre de colonnes d'un bloc d'échantillons
+ *
+ */
+#define COLONNES_ECHANTILLONS 7 // graine, bot, tour, x, y, taille, score
+
+/**
+ *
+ * \def OCTETS_LIGNE_ECHANTILLON
+ *
+ * \brief constante pour la taille en octets d'une ligne d'un bloc d'échantillons
+ *
+ */
+#define OCTETS_LIGNE_ECHANTILLON (4 + 1 + 4 + 1 + 1 + 2 + 2) // Somme des tailles des colonnes
+
+/**
+ *
+ * \def CAUSE_VICTOIRE
+ *
+ * \brief constante pour une partie terminée sans collision, toutes les pommes mangées
+ *
+ */
+#define CAUSE_VICTOIRE 0 // Toutes les pommes mangées
+
+/**
+ *
+ * \def CAUSE_BORDURE
+ *
+ * \brief constante pour une partie terminée contre une bordure du plateau
+ *
+ */
+#define CAUSE_BORDURE 1 // Collision avec une bordure
+
+/**
+ *
+ * \def CAUSE_PAVE
+ *
+ * \brief constante pour une partie terminée contre un pavé
+ *
+ */
+#define CAUSE_PAVE 2 // Collision avec un pavé
+
+/**
+ *
+ * \def CAUSE_CORPS
+ *
+ * \brief constante pour une partie terminée contre le corps du serpent
+ *
+ */
+#define CAUSE_CORPS 3 // Collision avec le serpent lui-même
+
+/**
+ *
+ * \def CAUSE_TOURS
+ *
+ * \brief constante pour une partie arrêtée sans collision par la limite de tours, avant d'avoir mangé toutes les pommes
+ *
+ */
+#define CAUSE_TOURS 4 // Limite de tours atteinte
+
+/**
+ *
+ * \def NOMBRE_CAUSES
+ *
+ * \brief constante pour le nombre de causes de fin de partie
+ *
+ */
+#define NOMBRE_CAUSES 5 // Nombre de causes
+
+
+// ------------------------------- TYPES ----------------------------------------
+
+/**
+ *
+ * \struct EnteteBloc
+ *
+ * \brief En-tête de chaque bloc du fichier (12 octets)
+ *
+ */
+typedef struct
+{
+    char type; // BLOC_NOMS, BLOC_PARTIES ou BLOC_ECHANTILLONS
+    uint8_t version; // VERSION_TELEMETRIE
+    uint16_t colonnes; // Nombre de colonnes
+    uint32_t lignes; // Nombre de lignes (de noms pour un bloc de noms)
+    uint32_t octets; // Taille des colonnes qui suivent l'en-tête
+} EnteteBloc;
+
+/**
+ *
+ * \struct Telemetrie
+ *
+ * \brief Fichier de télémétrie partagé entre les threads
+ *
+ */
+typedef struct
+{
+    int descripteur; // Fichier ouvert en ajout
+    pthread_mutex_t verrou; // Un seul bloc écrit à la fois
+    bool erreur; // Une écriture a échoué
+} Telemetrie;
+
+/**
+ *
+ * \struct TamponTelemetrie
+ *
+ * \brief Colonnes d'un thread, en attente d'écriture
+ *
+ */
+typedef struct
+{
+    Telemetrie *telemetrie; // Fichier dans lequel les blocs sont écrits
+    int periode; // Un échantillon tous les periode tours (0 : aucun échantillon)
+    uint32_t nombreParties; // Lignes en attente dans les colonnes des parties
+    uint32_t graines[LIGNES_BLOC]; // Graine de la partie
+    uint8_t bots[LIGNES_BLOC]; // Indice du bot dans le dernier bloc de noms
+    uint16_t scores[LIGNES_BLOC]; // Nombre de pommes mangées
+    uint16_t tailles[LIGNES_BLOC]; // Taille finale du serpent
+    uint32_t tours[LIGNES_BLOC]; // Nombre de mouvements joués
+    uint8_t causes[LIGNES_BLOC]; // Cause de la fin de la partie
+    uint32_t nombreEchantillons; // Lignes en attente dans les colonnes des échantillons
+    uint32_t graineEchantillons[LIGNES_BLOC]; // Graine de la partie
+    uint8_t botEchantillons[LIGNES_BLOC]; // Indice du bot
+    uint32_t tourEchantillons[LIGNES_BLOC]; // Tour de l'échantillon
+    uint8_t xTetes[LIGNES_BLOC]; // Coordonnée X de la tête
+    uint8_t yTetes[LIGNES_BLOC]; // Coordonnée Y de la tête
+    uint16_t tailleEchantillons[LIGNES_BLOC]; // Taille du serpent
+    uint16_t scoreEchantillons[LIGNES_BLOC]; // Nombre de pommes mangées
+} TamponTelemetrie;
+
+
+// Noms des causes de fin de partie, dans l'ordre de leurs valeurs
+static const char *const NOMS_CAUSES[NOMBRE_CAUSES] = {"victoire", "bordure", "pave", "corps", "tours"};
+
+
+// Prototypes des fonctions
+bool ouvrirTelemetrie(Telemetrie *telemetrie, const char *chemin, const char *const noms[], int nombreNoms); // Ouvre le fichier en ajout et y écrit les noms des bots
+void initTampon(TamponTelemetrie *tampon, Telemetrie *telemetrie, int periode); // Prépare les colonnes d'un thread
+int causeFin(const Partie *partie); // Cause de la fin d'une partie
+void noterPartie(TamponTelemetrie *tampon, uint32_t graine, int bot, const Partie *partie); // Ajoute le résultat d'une partie
+void noterEchantillon(TamponTelemetrie *tampon, uint32_t graine, int bot, const Partie *partie); // Ajoute un échantillon de la partie en cours
+void ecrireBloc(Telemetrie *telemetrie, char type, struct iovec colonnes[], int nombreColonnes, uint32_t lignes); // Écrit un bloc d'un seul appel
+void viderTampon(TamponTelemetrie *tampon); // Écrit les colonnes en attente
+bool fermerTelemetrie(Telemetrie *telemetrie); // Ferme le fichier
+
+
+// Fonctions
+
+/**
+ * \fn bool ouvrirTelemetrie(Telemetrie *telemetrie, const char *chemin, const char *const noms[], int nombreNoms)
+ * \brief Ouvre (ou crée) le fichier en ajout et y écrit un bloc de noms des bots.
+ *
+ * \param telemetrie Fichier de télémétrie.
+ * \param chemin Chemin du fichier.
+ * \param noms Noms des bots, dans l'ordre de leurs indices.
+ * \param nombreNoms Nombre de bots.
+ * \return true si le fichier est prêt, false sinon.
+ */
+bool ouvrirTelemetrie(Telemetrie *telemetrie, const char *chemin, const char *const noms[], int nombreNoms) // Ouvre le fichier en ajout et y écrit les noms des bots
+{
+    struct iovec colonnes[UINT8_MAX + 1];
+    telemetrie->descripteur = open(chemin, O_WRONLY | O_CREAT | O_APPEND, 0644);
+    telemetrie->erreur = false;
+    if ((telemetrie->descripteur < 0) || (nombreNoms > UINT8_MAX + 1))
+    {
+        return false;
+    }
+    pthread_mutex_init(&telemetrie->verrou, NULL);
+    for (int i = 0; i < nombreNoms; i++)
+    {
+        colonnes[i] = (struct iovec){(void *)noms[i], strlen(noms[i]) + 1}; // Avec le '\0'
+    }
+    ecrireBloc(telemetrie, BLOC_NOMS, colonnes, nombreNoms, nombreNoms);
+    return telemetrie->erreur == false;
+}
+
+/**
+ * \fn void initTampon(TamponTelemetrie *tampon, Telemetrie *telemetrie, int periode)
+ * \brief Prépare les colonnes vides d'un thread.
+ *
+ * \param tampon Colonnes du thread.
+ * \param telemetrie Fichier dans lequel les blocs seront écrits.
+ * \param periode Un échantillon tous les periode tours, 0 pour n'exporter que les résultats des parties.
+ */
+void initTampon(TamponTelemetrie *tampon, Telemetrie *telemetrie, int periode) // Prépare les colonnes d'un thread
+{
+    tampon->telemetrie = telemetrie;
+    tampon->periode = periode;
+    tampon->nombreParties = 0;
+    tampon->nombreEchantillons = 0;
+}
+
+/**
+ * \fn int causeFin(const Partie *partie)
+ * \brief Cause de la fin d'une partie, retrouvée à partir de la case de la tête (le jeu ne note que la collision).
+ *
+ * Une partie sans collision est gagnée si toutes les pommes ont été mangées ; sinon, elle a été arrêtée par la limite de tours.
+ *
+ * \param partie Partie terminée.
+ * \return CAUSE_VICTOIRE, CAUSE_BORDURE, CAUSE_PAVE, CAUSE_CORPS ou CAUSE_TOURS.
+ */
+int causeFin(const Partie *partie) // Cause de la fin d'une partie
+{
+    int x = partie->lesX[0];
+    int y = partie->lesY[0];
+    if (partie->collision == false)
+    {
+        return (partie->score == NOMBRE_DE_POMMES) ? CAUSE_VICTOIRE : CAUSE_TOURS;
+    }
+    if (caseObstacle(partie, x, y)) // Une bordure est sur le contour du plateau, un pavé à l'intérieur
+    {
+        return ((x == X_BORDURE_GAUCHE_PLATEAU) || (x == X_BORDURE_DROITE_PLATEAU) || (y == Y_BORDURE_HAUT_PLATEAU) || (y == Y_BORDURE_BAS_PLATEAU)) ? CAUSE_BORDURE : CAUSE_PAVE;
+    }
+    return CAUSE_CORPS;
+}
+
+/**
+ * \fn void noterPartie(TamponTelemetrie *tampon, uint32_t graine, int bot, const Partie *partie)
+ * \brief Ajoute le résultat d'une partie terminée aux colonnes du thread, et les écrit si elles sont pleines.
+ *
+ * \param tampon Colonnes du thread.
+ * \param graine Graine de la partie.
+ * \param bot Indice du bot qui a joué la partie.
+ * \param partie Partie terminée.
+ */
+void noterPartie(TamponTelemetrie *tampon, uint32_t graine, int bot, const Partie *partie) // Ajoute le résultat d'une partie
+{
+    uint32_t i = tampon->nombreParties++;
+    tampon->graines[i] = graine;
+    tampon->bots[i] = bot;
+    tampon->scores[i] = partie->score;
+    tampon->tailles[i] = partie->taille;
+    tampon->tours[i] = partie->tours;
+    tampon->causes[i] = causeFin(partie);
+    if (tampon->nombreParties == LIGNES_BLOC)
+    {
+        viderTampon(tampon);
+    }
+}
+
+/**
+ * \fn void noterEchantillon(TamponTelemetrie *tampon, uint32_t graine, int bot, const Partie *partie)
+ * \brief Ajoute un échantillon de la partie en cours aux colonnes du thread, et les écrit si elles sont pleines.
+ *
+ * \param tampon Colonnes du thread.
+ * \param graine Graine de la partie.
+ * \param bot Indice du bot qui joue la partie.
+ * \param partie Partie en cours.
+ */
+void noterEchantillon(TamponTelemetrie *tampon, uint32_t graine, int bot, const Partie *partie) // Ajoute un échantillon de la partie en cours
+{
+    uint32_t i = tampon->nombreEchantillons++;
+    tampon->graineEchantillons[i] = graine;
+    tampon->botEchantillons[i] = bot;
+    tampon->tourEchantillons[i] = partie->tours;
+    tampon->xTetes[i] = partie->lesX[0];
+    tampon->yTetes[i] = partie->lesY[0];
+    tampon->tailleEchantillons[i] = partie->taille;
+    tampon->scoreEchantillons[i] = partie->score;
+    if (tampon->nombreEchantillons == LIGNES_BLOC)
+    {
+        viderTampon(tampon);
+    }
+}
+
+/**
+ * \fn void ecrireBloc(Telemetrie *telemetrie, char type, struct iovec colonnes[], int nombreColonnes, uint32_t lignes)
+ * \brief Écrit un bloc (en-tête et colonnes) à la fin du fichier, d'un seul appel à writev().
+ *
+ * \param telemetrie Fichier de télémétrie.
+ * \param type Type du bloc.
+ * \param colonnes Colonnes du bloc.
+ * \param nombreColonnes Nombre de colonnes.
+ * \param lignes Nombre de lignes.
+ */
+void ecrireBloc(Telemetrie *telemetrie, char type, struct iovec colonnes[], int nombreColonnes, uint32_t lignes) // Écrit un bloc d'un seul appel
+{
+    struct iovec morceaux[UINT8_MAX + 2]; // En-tête puis colonnes
+    EnteteBloc entete = {type, VERSION_TELEMETRIE, nombreColonnes, lignes, 0};
+    size_t total = sizeof(entete);
+    for (int i = 0; i < nombreColonnes; i++)
+    {
+        entete.octets += colonnes[i].iov_len;
+        morceaux[i + 1] = colonnes[i];
+    }
+    morceaux[0] = (struct iovec){&entete, sizeof(entete)};
+    total += entete.octets;
+    pthread_mutex_lock(&telemetrie->verrou);
+    if (writev(telemetrie->descripteur, morceaux, nombreColonnes + 1) != (ssize_t)total) // Un fichier en ajout reçoit le bloc d'un seul tenant
+    {
+        telemetrie->erreur = true;
+    }
+    pthread_mutex_unlock(&telemetrie->verrou);
+}
+
+/**
+ * \fn void viderTampon(TamponTelemetrie *tampon)
+ * \brief Écrit les colonnes en attente du thread (un bloc de parties et un bloc d'échantillons au plus).
+ *
+ * \param tampon Colonnes du thread.
+ */
+void viderTampon(TamponTelemetrie *tampon) // Écrit les colonnes en attente
+{
+    uint32_t n = tampon->nombreParties;
+    if (n > 0)
+    {
+        struct iovec colonnes[COLONNES_PARTIES] = {
+            {tampon->graines, n * sizeof(uint32_t)}, {tampon->bots, n * sizeof(uint8_t)}, {tampon->scores, n * sizeof(uint16_t)},
+            {tampon->tailles, n * sizeof(uint16_t)}, {tampon->tours, n * sizeof(uint32_t)}, {tampon->causes, n * sizeof(uint8_t)}};
+        ecrireBloc(tampon->telemetrie, BLOC_PARTIES, colonnes, COLONNES_PARTIES, n);
+        tampon->nombreParties = 0;
+    }
+    n = tampon->nombreEchantillons;
+    if (n > 0)
+    {
+        struct iovec colonnes[COLONNES_ECHANTILLONS] = {
+            {tampon->graineEchantillons, n * sizeof(uint32_t)}, {tampon->botEchantillons, n * sizeof(uint8_t)}, {tampon->tourEchantillons, n * sizeof(uint32_t)},
+            {tampon->xTetes, n * sizeof(uint8_t)}, {tampon->yTetes, n * sizeof(uint8_t)}, {tampon->tailleEchantillons, n * sizeof(uint16_t)}, {tampon->scoreEchantillons, n * sizeof(uint16_t)}};
+        ecrireBloc(tampon->telemetrie, BLOC_ECHANTILLONS, colonnes, COLONNES_ECHANTILLONS, n);
+        tampon->nombreEchantillons = 0;
+    }
+}
+
+/**
+ * \fn bool fermerTelemetrie(Telemetrie *telemetrie)
+ * \brief Ferme le fichier de télémétrie (les colonnes de chaque thread doivent avoir été vidées).
+ *
+ * \param telemetrie Fichier de télémétrie.
+ * \return true si toutes les écritures ont réussi, false sinon.
+ */
+bool fermerTelemetrie(Telemetrie *telemetrie) // Ferme le fichier
+{
+    bool reussite = (close(telemetrie->descripteur) == 0) && (telemetrie->erreur == false);
+    pthread_mutex_destroy(&telemetrie->verrou);
+    return reussite;
+}
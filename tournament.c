@@ -0,0 +1,449 @@
+/**
+* \page Tournoi
+* \brief Tournoi des bots du jeu Snake, joué en parallèle sur tous les cœurs.
+* \author Ewen THÉPOT
+*
+* Chaque bot joue les mêmes parties (même graine, donc même plateau et mêmes pommes).
+* Les bots sont ensuite comparés deux à deux sur chaque partie (round-robin) : le meilleur score gagne,
+* à score égal le serpent le plus rapide gagne. Le tournoi affiche un classement Elo avec son intervalle
+* de confiance à 95 %, ainsi que le débit de chaque bot (parties et tours par seconde). Les comparaisons d'une même
+* partie ne sont pas indépendantes : la variance est calculée sur la proportion de points de chaque bot par partie.
+*
+* Les parties sont jouées avec initPartie() et jouerTour(), c'est-à-dire avec les mêmes règles que le jeu.
+*
+* Utilisation : ./tournament [nombre de parties] [nombre de threads] [sauvegarde de l'entraînement|-] [télémétrie] [période]
+*
+* Le bot pondéré utilise les poids par défaut, ou les meilleurs poids de la sauvegarde de l'outil entrainement si elle est donnée.
+* Si un fichier de télémétrie est donné, le résultat de chaque partie y est ajouté (voir telemetrie.c),
+* ainsi qu'un échantillon tous les période tours de chaque partie si une période est donnée ; ./bilan le résume.
+*/
+
+#define SNAKE_SANS_MAIN // Réutiliser le moteur du jeu sans son programme principal
+#include "snake.c"
+#include "bots.c"
+#include "telemetrie.c"
+
+#include <string.h>
+#include <math.h> // Pour le calcul des classements Elo
+#include <pthread.h> // Pour jouer les parties en parallèle
+#include <stdatomic.h> // Pour distribuer les parties entre les threads
+
+// ----------------------------- CONSTANTES -------------------------------------
+
+/**
+ *
+ * \def NOMBRE_PARTIES_DEFAUT
+ *
+ * \brief constante pour le nombre de parties jouées par chaque bot par défaut
+ *
+ */
+#define NOMBRE_PARTIES_DEFAUT 200 // Nombre de parties (plateaux) par défaut
+
+/**
+ *
+ * \def GRAINE_TOURNOI
+ *
+ * \brief constante pour la graine de la première partie du tournoi
+ *
+ * \details La partie i est jouée avec la graine GRAINE_TOURNOI + i, le tournoi est donc reproductible.
+ *
+ */
+#define GRAINE_TOURNOI 20241130 // Graine de la première partie
+
+/**
+ *
+ * \def Z_CONFIANCE
+ *
+ * \brief constante pour le quantile de la loi normale utilisé pour l'intervalle de confiance à 95 %
+ *
+ */
+#define Z_CONFIANCE 1.96 // Intervalle de confiance à 95 %
+
+
+// ------------------------------- TYPES ----------------------------------------
+
+/**
+ *
+ * \struct Politique
+ *
+ * \brief Bot participant au tournoi
+ *
+ */
+typedef struct
+{
+    const char *nom; // Nom affiché dans le classement
+    char (*choisir)(const Partie *partie); // Fonction choisissant la direction du serpent
+} Politique;
+
+/**
+ *
+ * \struct Resultat
+ *
+ * \brief Résultat d'une partie jouée par un bot
+ *
+ */
+typedef struct
+{
+    int score; // Nombre de pommes mangées
+    long tours; // Nombre de mouvements joués
+    double secondes; // Temps de calcul de la partie (temps CPU du thread)
+} Resultat;
+
+/**
+ *
+ * \struct Tournoi
+ *
+ * \brief Parties du tournoi partagées entre les threads
+ *
+ */
+typedef struct
+{
+    Resultat *resultats; // Résultats, rangés par partie puis par bot
+    int nombreParties; // Nombre de parties jouées par chaque bot
+    atomic_int prochainePartie; // Indice de la prochaine partie à jouer
+    Niveau niveau; // Niveau commun à toutes les parties, préparé avant le lancement des threads
+} Tournoi;
+
+/**
+ *
+ * \struct Travailleur
+ *
+ * \brief Paramètres d'un thread du tournoi
+ *
+ */
+typedef struct
+{
+    Tournoi *tournoi; // Tournoi partagé entre les threads
+    Partie *gabarit; // Partie initialisée une fois par graine, copiée pour chaque bot
+    Partie *partie; // Partie jouée par les bots, remise à l'état du gabarit avant chaque bot
+    TamponTelemetrie *tampon; // Colonnes de télémétrie du thread, NULL sans télémétrie
+} Travailleur;
+
+
+// Poids du bot pondéré, lus avant le lancement des threads puis seulement consultés
+static double poidsTournoi[NOMBRE_POIDS];
+
+// Prototype du bot pondéré utilisé dans le tournoi
+char botPondereTournoi(const Partie *partie); // Bot pondéré avec les poids du tournoi
+
+// Bots participant au tournoi
+static const Politique POLITIQUES[] = {
+    {"glouton", botGlouton},
+    {"chemin", botChemin},
+    {"anticipation", botAnticipation},
+    {"pondere", botPondereTournoi},
+};
+
+/**
+ *
+ * \def NOMBRE_POLITIQUES
+ *
+ * \brief constante pour le nombre de bots participant au tournoi
+ *
+ */
+#define NOMBRE_POLITIQUES ((int)(sizeof(POLITIQUES) / sizeof(POLITIQUES[0]))) // Nombre de bots du tournoi
+
+
+// Prototypes des fonctions
+double secondesCPU(); // Temps CPU consommé par le thread appelant
+void jouerPartieBot(const Politique *politique, const Partie *gabarit, Partie *partie, Resultat *resultat, TamponTelemetrie *tampon, unsigned int graine, int bot); // Joue une partie complète avec un bot
+void *jouerParties(void *argument); // Fonction exécutée par chaque thread du tournoi
+int comparerResultats(const Resultat *a, const Resultat *b); // Compare deux résultats obtenus sur la même partie
+double elo(double proportion); // Convertit une proportion de points en écart Elo
+
+
+// Programme principal
+
+/**
+* \fn int main(int argc, char *argv[])
+* \brief Joue le tournoi et affiche le classement des bots.
+*
+* \param argc Nombre d'arguments.
+* \param argv Arguments : nombre de parties, nombre de threads (tous les cœurs par défaut), sauvegarde de l'entraînement (- pour aucune), fichier et période de télémétrie.
+* \return 0 en cas de succès, une autre valeur en cas d'erreur.
+*/
+int main(int argc, char *argv[])
+{
+    int nombreParties = (argc > 1) ? atoi(argv[1]) : NOMBRE_PARTIES_DEFAUT; // Nombre de parties jouées par chaque bot
+    int nombreThreads = (argc > 2) ? atoi(argv[2]) : (int)sysconf(_SC_NPROCESSORS_ONLN); // Un thread par cœur par défaut
+    if ((nombreParties <= 0) || (nombreThreads <= 0))
+    {
+        fprintf(stderr, "Utilisation : %s [nombre de parties] [nombre de threads] [sauvegarde de l'entraînement|-] [télémétrie] [période]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    for (int i = 0; i < NOMBRE_POIDS; i++)
+    {
+        poidsTournoi[i] = POIDS_DEFAUT[i];
+    }
+    if ((argc > 3) && (strcmp(argv[3], "-") != 0) && (chargerPoids(argv[3], poidsTournoi) == false))
+    {
+        fprintf(stderr, "Impossible de lire les poids de %s\n", argv[3]);
+        return EXIT_FAILURE;
+    }
+    static Tournoi tournoi; // Hors de la pile : la table des liens du niveau est volumineuse
+    tournoi.nombreParties = nombreParties;
+    initNiveauStandard(&tournoi.niveau);
+    tournoi.resultats = malloc(sizeof(Resultat) * nombreParties * NOMBRE_POLITIQUES);
+    pthread_t *threads = malloc(sizeof(pthread_t) * nombreThreads);
+    Travailleur *travailleurs = malloc(sizeof(Travailleur) * nombreThreads);
+    PoolParties pool; // Toutes les parties du tournoi, réservées en une fois : deux par thread
+    if ((tournoi.resultats == NULL) || (threads == NULL) || (travailleurs == NULL) || (creerPool(&pool, 2 * nombreThreads) == false))
+    {
+        perror("malloc");
+        return EXIT_FAILURE;
+    }
+    atomic_init(&tournoi.prochainePartie, 0);
+    static Telemetrie telemetrie; // Fichier de télémétrie partagé par les threads
+    const char *noms[NOMBRE_POLITIQUES];
+    for (int p = 0; p < NOMBRE_POLITIQUES; p++)
+    {
+        noms[p] = POLITIQUES[p].nom;
+    }
+    if ((argc > 4) && (ouvrirTelemetrie(&telemetrie, argv[4], noms, NOMBRE_POLITIQUES) == false))
+    {
+        perror(argv[4]);
+        return EXIT_FAILURE;
+    }
+    // Jouer les parties en parallèle
+    struct timespec debut, fin;
+    clock_gettime(CLOCK_MONOTONIC, &debut);
+    for (int i = 0; i < nombreThreads; i++)
+    {
+        travailleurs[i].tournoi = &tournoi;
+        travailleurs[i].gabarit = prendrePartie(&pool);
+        travailleurs[i].partie = prendrePartie(&pool);
+        travailleurs[i].tampon = NULL;
+        if (argc > 4) // Des colonnes par thread : aucun verrou avant qu'elles soient pleines
+        {
+            travailleurs[i].tampon = malloc(sizeof(TamponTelemetrie));
+            if (travailleurs[i].tampon == NULL)
+            {
+                perror("malloc");
+                return EXIT_FAILURE;
+            }
+            initTampon(travailleurs[i].tampon, &telemetrie, (argc > 5) ? atoi(argv[5]) : 0);
+        }
+        if (pthread_create(&threads[i], NULL, jouerParties, &travailleurs[i]) != 0)
+        {
+            perror("pthread_create");
+            return EXIT_FAILURE;
+        }
+    }
+    for (int i = 0; i < nombreThreads; i++)
+    {
+        pthread_join(threads[i], NULL);
+        rendrePartie(&pool, travailleurs[i].partie);
+        rendrePartie(&pool, travailleurs[i].gabarit);
+        if (travailleurs[i].tampon != NULL)
+        {
+            viderTampon(travailleurs[i].tampon); // Dernier bloc, incomplet
+            free(travailleurs[i].tampon);
+        }
+    }
+    if ((argc > 4) && (fermerTelemetrie(&telemetrie) == false))
+    {
+        fprintf(stderr, "Télémétrie incomplète : %s\n", argv[4]);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &fin);
+    double duree = (fin.tv_sec - debut.tv_sec) + (fin.tv_nsec - debut.tv_nsec) / 1e9;
+    // Comparer les bots deux à deux sur chaque partie
+    int victoires[NOMBRE_POLITIQUES][NOMBRE_POLITIQUES] = {{0}}; // victoires[a][b] : parties où a bat b
+    int nuls[NOMBRE_POLITIQUES] = {0};
+    double sommeCarres[NOMBRE_POLITIQUES] = {0.0}; // Somme des carrés des proportions de points obtenues sur chaque partie
+    for (int p = 0; p < nombreParties; p++)
+    {
+        const Resultat *resultats = &tournoi.resultats[p * NOMBRE_POLITIQUES];
+        double points[NOMBRE_POLITIQUES] = {0.0}; // Points de chaque bot sur cette partie
+        for (int a = 0; a < NOMBRE_POLITIQUES; a++)
+        {
+            for (int b = a + 1; b < NOMBRE_POLITIQUES; b++)
+            {
+                int comparaison = comparerResultats(&resultats[a], &resultats[b]);
+                if (comparaison > 0)
+                {
+                    victoires[a][b]++;
+                    points[a] += 1.0;
+                }
+                else if (comparaison < 0)
+                {
+                    victoires[b][a]++;
+                    points[b] += 1.0;
+                }
+                else
+                {
+                    nuls[a]++;
+                    nuls[b]++;
+                    points[a] += 0.5;
+                    points[b] += 0.5;
+                }
+            }
+        }
+        for (int a = 0; a < NOMBRE_POLITIQUES; a++) // Un échantillon par partie et par bot
+        {
+            sommeCarres[a] += pow(points[a] / (NOMBRE_POLITIQUES - 1), 2);
+        }
+    }
+    // Afficher le classement
+    printf("Tournoi : %d bots, %d parties chacun, %d threads, %.2f s\n\n", NOMBRE_POLITIQUES, nombreParties, nombreThreads, duree);
+    printf("%-14s %7s %17s %15s %8s %8s %11s %12s\n", "Bot", "Elo", "IC 95 %", "V/N/D", "Pommes", "Gagnées", "Parties/s", "Tours/s");
+    for (int a = 0; a < NOMBRE_POLITIQUES; a++)
+    {
+        int gagnees = 0, perdues = 0, pommes = 0, completes = 0;
+        long tours = 0;
+        double secondes = 0.0;
+        for (int b = 0; b < NOMBRE_POLITIQUES; b++)
+        {
+            gagnees += victoires[a][b];
+            perdues += victoires[b][a];
+        }
+        for (int p = 0; p < nombreParties; p++)
+        {
+            const Resultat *resultat = &tournoi.resultats[p * NOMBRE_POLITIQUES + a];
+            pommes += resultat->score;
+            completes += (resultat->score == NOMBRE_DE_POMMES);
+            tours += resultat->tours;
+            secondes += resultat->secondes;
+        }
+        int rencontres = gagnees + nuls[a] + perdues; // Nombre de comparaisons deux à deux
+        double proportion = (gagnees + 0.5 * nuls[a]) / rencontres; // Proportion de points obtenus
+        double variance = (nombreParties > 1) ? (sommeCarres[a] - nombreParties * proportion * proportion) / (nombreParties - 1) : 0.0; // Variance entre parties
+        double marge = Z_CONFIANCE * sqrt(fmax(variance, 0.0) / nombreParties);
+        char intervalle[32], bilan[32];
+        snprintf(intervalle, sizeof(intervalle), "[%+.0f, %+.0f]", elo(proportion - marge), elo(proportion + marge));
+        snprintf(bilan, sizeof(bilan), "%d/%d/%d", gagnees, nuls[a], perdues);
+        printf("%-14s %+7.0f %17s %15s %8.2f %7d%% %11.1f %12.0f\n", POLITIQUES[a].nom, elo(proportion), intervalle, bilan, (double)pommes / nombreParties, (100 * completes) / nombreParties, nombreParties / secondes, tours / secondes);
+    }
+    detruirePool(&pool);
+    free(travailleurs);
+    free(threads);
+    free(tournoi.resultats);
+    return EXIT_SUCCESS;
+}
+
+
+// Fonctions
+
+/**
+ * \fn char botPondereTournoi(const Partie *partie)
+ * \brief Bot pondéré avec les poids du tournoi.
+ *
+ * \param partie Partie en cours.
+ * \return La direction choisie.
+ */
+char botPondereTournoi(const Partie *partie) // Bot pondéré avec les poids du tournoi
+{
+    return botPondere(partie, poidsTournoi);
+}
+
+/**
+ * \fn double secondesCPU()
+ * \brief Temps CPU consommé par le thread appelant.
+ *
+ * \return Le temps CPU en secondes.
+ */
+double secondesCPU() // Temps CPU consommé par le thread appelant
+{
+    struct timespec instant;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &instant);
+    return instant.tv_sec + instant.tv_nsec / 1e9;
+}
+
+/**
+ * \fn void jouerPartieBot(const Politique *politique, const Partie *gabarit, Partie *partie, Resultat *resultat, TamponTelemetrie *tampon, unsigned int graine, int bot)
+ * \brief Joue une partie complète avec un bot, sans affichage.
+ *
+ * \param politique Bot qui joue la partie.
+ * \param gabarit Partie initialisée avec la graine de la partie.
+ * \param partie Partie de travail, remise à l'état du gabarit.
+ * \param resultat Résultat de la partie.
+ * \param tampon Colonnes de télémétrie du thread, ou NULL.
+ * \param graine Graine de la partie.
+ * \param bot Indice du bot dans le tournoi.
+ */
+void jouerPartieBot(const Politique *politique, const Partie *gabarit, Partie *partie, Resultat *resultat, TamponTelemetrie *tampon, unsigned int graine, int bot) // Joue une partie complète avec un bot
+{
+    double debut = secondesCPU();
+    int periode = (tampon != NULL) ? tampon->periode : 0;
+    reinitialiserPartie(partie, gabarit); // Une copie au lieu de reconstruire le plateau
+    while ((partieTerminee(partie) == false) && (partie->tours < TOURS_MAX_PARTIE)) // Jouer jusqu'à la fin de la partie
+    {
+        if ((periode > 0) && ((partie->tours % periode) == 0)) // Échantillon de la partie en cours
+        {
+            noterEchantillon(tampon, graine, bot, partie);
+        }
+        jouerTour(partie, politique->choisir(partie));
+    }
+    resultat->score = partie->score;
+    resultat->tours = partie->tours;
+    resultat->secondes = secondesCPU() - debut;
+    if (tampon != NULL)
+    {
+        noterPartie(tampon, graine, bot, partie);
+    }
+}
+
+/**
+ * \fn void *jouerParties(void *argument)
+ * \brief Fonction exécutée par chaque thread : joue les parties du tournoi tant qu'il en reste.
+ *
+ * Chaque partie est préparée une seule fois dans le gabarit du thread, puis jouée par tous les bots.
+ *
+ * \param argument Pointeur vers les paramètres du thread.
+ * \return NULL.
+ */
+void *jouerParties(void *argument) // Fonction exécutée par chaque thread du tournoi
+{
+    Travailleur *travailleur = argument;
+    Tournoi *tournoi = travailleur->tournoi;
+    int partie;
+    while ((partie = atomic_fetch_add(&tournoi->prochainePartie, 1)) < tournoi->nombreParties) // Prendre la prochaine partie à jouer
+    {
+        initPartie(travailleur->gabarit, &tournoi->niveau, GRAINE_TOURNOI + partie, false);
+        for (int p = 0; p < NOMBRE_POLITIQUES; p++)
+        {
+            jouerPartieBot(&POLITIQUES[p], travailleur->gabarit, travailleur->partie, &tournoi->resultats[partie * NOMBRE_POLITIQUES + p], travailleur->tampon, GRAINE_TOURNOI + partie, p);
+        }
+    }
+    return NULL;
+}
+
+/**
+ * \fn int comparerResultats(const Resultat *a, const Resultat *b)
+ * \brief Compare deux résultats obtenus sur la même partie.
+ *
+ * Le meilleur score gagne ; à score égal, le serpent qui a mangé toutes les pommes le plus vite gagne.
+ *
+ * \param a Premier résultat.
+ * \param b Second résultat.
+ * \return Une valeur positive si a gagne, négative si b gagne, 0 en cas de match nul.
+ */
+int comparerResultats(const Resultat *a, const Resultat *b) // Compare deux résultats obtenus sur la même partie
+{
+    int comparaison = a->score - b->score;
+    if ((comparaison == 0) && (a->score == NOMBRE_DE_POMMES)) // Les deux bots ont gagné
+    {
+        comparaison = (a->tours < b->tours) - (a->tours > b->tours);
+    }
+    return comparaison;
+}
+
+/**
+ * \fn double elo(double proportion)
+ * \brief Convertit une proportion de points en écart Elo par rapport aux autres bots.
+ *
+ * \param proportion Proportion de points obtenus (entre 0 et 1).
+ * \return L'écart Elo, borné pour les proportions de 0 ou 1.
+ */
+double elo(double proportion) // Convertit une proportion de points en écart Elo
+{
+    const double borne = 1e-3; // Éviter les écarts infinis
+    if (proportion < borne)
+    {
+        proportion = borne;
+    }
+    else if (proportion > 1.0 - borne)
+    {
+        proportion = 1.0 - borne;
+    }
+    return -400.0 * log10(1.0 / proportion - 1.0);
+}